@@ -0,0 +1,78 @@
+/* --------------------------------------------
+ Description: This implementation file replaces the global operator new and delete with versions that report every allocation to the counters in Memory.cpp. It is built as the separate ama_alloc object library, so only programs that link it pay for the counting. Each block carries its size in a header in front of it so a free can subtract the bytes it returns.
+ ----------------------------------------------- */
+
+#include <new>
+#include <stddef.h>
+#include <stdlib.h>
+#include "Memory.h"
+
+namespace {
+    
+    // keeps the block after the header aligned for any type
+    const size_t header_size = alignof(max_align_t) > sizeof(size_t) ? alignof(max_align_t) : sizeof(size_t);
+    
+    void* allocate(size_t size) {
+        void* block = malloc(size + header_size);
+        if(block == nullptr) {
+            return nullptr;
+        }
+        *static_cast<size_t*>(block) = size;
+        AMA::countAllocation(size);
+        return static_cast<char*>(block) + header_size;
+    }
+    
+    void release(void* ptr) {
+        if(ptr != nullptr) {
+            void* block = static_cast<char*>(ptr) - header_size;
+            AMA::countFree(*static_cast<size_t*>(block));
+            free(block);
+        }
+    }
+
+}
+
+// counts the allocation and forwards it to malloc
+void* operator new(size_t size) {
+    void* ptr = allocate(size == 0 ? 1 : size);
+    if(ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    release(ptr);
+}
@@ -0,0 +1,512 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the ArchiveWriter and ArchiveReader classes.
+ Column encodings: type and taxed are bit packed, sku and name are null separated, unit is an id into the archive dictionary, qty and qtyNeeded use frame of reference, expiry stores day number deltas and price is stored as is.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include "BitStream.h"
+#include "RecordReader.h"
+#include "Archive.h"
+
+namespace AMA {
+    
+    static const char archive_magic[8] = { 'A', 'M', 'A', 'A', 'R', 'C', '0', '1' };
+    
+    // encodes the type column, one bit per record when every type is 'N' or 'P'
+    static void encodeType(const std::vector<Record>& recs, std::vector<uint8_t>& out) {
+        bool packed = true;
+        for(size_t i = 0; i < recs.size(); i++) {
+            packed = packed && (recs[i].type == 'N' || recs[i].type == 'P');
+        }
+        out.push_back(packed ? 0 : 1);
+        if(packed) {
+            BitWriter bits(out);
+            for(size_t i = 0; i < recs.size(); i++) {
+                bits.write(recs[i].type == 'P', 1);
+            }
+            bits.flush();
+        } else {
+            for(size_t i = 0; i < recs.size(); i++) {
+                out.push_back((uint8_t)recs[i].type);
+            }
+        }
+    }
+    
+    // encodes a text column as null separated strings
+    static void encodeText(const std::vector<Record>& recs, size_t field, std::vector<uint8_t>& out) {
+        for(size_t i = 0; i < recs.size(); i++) {
+            const char* str = reinterpret_cast<const char*>(&recs[i]) + field;
+            out.insert(out.end(), str, str + strlen(str) + 1);
+        }
+    }
+    
+    // encodes values as a varint minimum followed by bit packed offsets from it
+    static void encodeFrame(const std::vector<int64_t>& values, std::vector<uint8_t>& out) {
+        int64_t min = values.empty() ? 0 : values[0];
+        int64_t max = min;
+        for(size_t i = 1; i < values.size(); i++) {
+            min = values[i] < min ? values[i] : min;
+            max = values[i] > max ? values[i] : max;
+        }
+        int width = bitWidth(uint64_t(max - min));
+        writeVarint(out, zigzag(min));
+        out.push_back((uint8_t)width);
+        BitWriter bits(out);
+        for(size_t i = 0; i < values.size(); i++) {
+            bits.write(uint64_t(values[i] - min), width);
+        }
+        bits.flush();
+    }
+    
+    // decodes count values written by encodeFrame()
+    static bool decodeFrame(const std::vector<uint8_t>& in, size_t count, std::vector<int64_t>& values) {
+        const uint8_t* p = in.data();
+        const uint8_t* end = p + in.size();
+        uint64_t min;
+        if(!readVarint(p, end, min) || p == end) {
+            return false;
+        }
+        int width = *p++;
+        BitReader bits(p, end - p);
+        int64_t base = unzigzag(min);
+        values.resize(count);
+        for(size_t i = 0; i < count; i++) {
+            values[i] = base + int64_t(bits.read(width));
+        }
+        return true;
+    }
+    
+    // encodes expiry as the difference from the previous expiry in the block
+    // code 0 means no expiry date, otherwise code - 1 is the zigzag difference
+    static void encodeExpiry(const std::vector<Record>& recs, std::vector<uint8_t>& out) {
+        std::vector<uint64_t> codes(recs.size());
+        uint64_t max = 0;
+        int32_t prev = 0;
+        for(size_t i = 0; i < recs.size(); i++) {
+            if(recs[i].expiry != 0) {
+                codes[i] = zigzag(int64_t(recs[i].expiry) - prev) + 1;
+                prev = recs[i].expiry;
+            }
+            max = codes[i] > max ? codes[i] : max;
+        }
+        int width = bitWidth(max);
+        out.push_back((uint8_t)width);
+        BitWriter bits(out);
+        for(size_t i = 0; i < codes.size(); i++) {
+            bits.write(codes[i], width);
+        }
+        bits.flush();
+    }
+    
+    // sets object to safe empty state, records are written in blocks of blockSize
+    ArchiveWriter::ArchiveWriter(int blockSize) {
+        blockSize_ = blockSize > 0 ? blockSize : archive_block_size;
+    }
+    
+    // finishes any archive still open
+    ArchiveWriter::~ArchiveWriter() {
+        if(file_.is_open()) {
+            close();
+        }
+    }
+    
+    // returns the dictionary id of unit, adding it if it is new
+    uint32_t ArchiveWriter::unitId(const char* unit) {
+        std::map<std::string, uint32_t>::iterator it = unitIds_.find(unit);
+        if(it == unitIds_.end()) {
+            it = unitIds_.insert(std::make_pair(std::string(unit), (uint32_t)units_.size())).first;
+            units_.push_back(unit);
+        }
+        return it->second;
+    }
+    
+    // creates the archive file at path
+    bool ArchiveWriter::open(const char* path) {
+        
+        error_.clear();
+        pending_.clear();
+        blocks_.clear();
+        units_.clear();
+        unitIds_.clear();
+        
+        file_.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file_.write(archive_magic, sizeof(archive_magic));
+        
+        if(!file_) {
+            error_.message("Unable to create archive file");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // adds rec to the current block, writing the block once it is full
+    bool ArchiveWriter::append(const Record& rec) {
+        pending_.push_back(rec);
+        if((int)pending_.size() >= blockSize_) {
+            return writeBlock();
+        }
+        return true;
+    }
+    
+    // encodes the pending records as one block and records its statistics
+    bool ArchiveWriter::writeBlock() {
+        
+        if(pending_.empty()) {
+            return true;
+        }
+        
+        BlockInfo info;
+        memset(&info, 0, sizeof(info));
+        info.offset = (uint64_t)file_.tellp();
+        info.count = (uint32_t)pending_.size();
+        
+        BlockStats& st = info.stats;
+        st.minQty = st.maxQty = pending_[0].qty;
+        st.minQtyNeeded = st.maxQtyNeeded = pending_[0].qtyNeeded;
+        st.minPrice = st.maxPrice = pending_[0].price;
+        strcpy(st.minSku, pending_[0].sku);
+        strcpy(st.maxSku, pending_[0].sku);
+        
+        std::vector<int64_t> qty(pending_.size());
+        std::vector<int64_t> needed(pending_.size());
+        std::vector<int64_t> unit(pending_.size());
+        
+        for(size_t i = 0; i < pending_.size(); i++) {
+            const Record& rec = pending_[i];
+            qty[i] = rec.qty;
+            needed[i] = rec.qtyNeeded;
+            unit[i] = unitId(rec.unit);
+            st.minQty = rec.qty < st.minQty ? rec.qty : st.minQty;
+            st.maxQty = rec.qty > st.maxQty ? rec.qty : st.maxQty;
+            st.minQtyNeeded = rec.qtyNeeded < st.minQtyNeeded ? rec.qtyNeeded : st.minQtyNeeded;
+            st.maxQtyNeeded = rec.qtyNeeded > st.maxQtyNeeded ? rec.qtyNeeded : st.maxQtyNeeded;
+            st.minPrice = rec.price < st.minPrice ? rec.price : st.minPrice;
+            st.maxPrice = rec.price > st.maxPrice ? rec.price : st.maxPrice;
+            if(rec.expiry != 0) {
+                st.minExpiry = st.minExpiry == 0 || rec.expiry < st.minExpiry ? rec.expiry : st.minExpiry;
+                st.maxExpiry = rec.expiry > st.maxExpiry ? rec.expiry : st.maxExpiry;
+            }
+            st.perishables += rec.type == 'P';
+            st.taxed += rec.taxed;
+            if(strcmp(rec.sku, st.minSku) < 0) {
+                strcpy(st.minSku, rec.sku);
+            }
+            if(strcmp(rec.sku, st.maxSku) > 0) {
+                strcpy(st.maxSku, rec.sku);
+            }
+        }
+        
+        std::vector<uint8_t> column[archive_columns];
+        
+        encodeType(pending_, column[0]);
+        encodeText(pending_, offsetof(Record, sku), column[1]);
+        encodeText(pending_, offsetof(Record, name), column[2]);
+        encodeFrame(unit, column[3]);
+        
+        BitWriter taxed(column[4]);
+        for(size_t i = 0; i < pending_.size(); i++) {
+            taxed.write(pending_[i].taxed, 1);
+        }
+        taxed.flush();
+        
+        column[5].resize(pending_.size() * sizeof(double));
+        for(size_t i = 0; i < pending_.size(); i++) {
+            memcpy(&column[5][i * sizeof(double)], &pending_[i].price, sizeof(double));
+        }
+        
+        encodeFrame(qty, column[6]);
+        encodeFrame(needed, column[7]);
+        encodeExpiry(pending_, column[8]);
+        
+        for(int c = 0; c < archive_columns; c++) {
+            info.length[c] = (uint32_t)column[c].size();
+            file_.write(reinterpret_cast<const char*>(column[c].data()), column[c].size());
+        }
+        
+        pending_.clear();
+        blocks_.push_back(info);
+        
+        if(!file_) {
+            error_.message("Unable to write archive block");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // writes the last block and the footer holding the unit dictionary and block directory
+    bool ArchiveWriter::close() {
+        
+        bool ok = file_.is_open() && writeBlock();
+        
+        if(ok) {
+            uint64_t footer = (uint64_t)file_.tellp();
+            uint32_t count = (uint32_t)units_.size();
+            file_.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for(size_t i = 0; i < units_.size(); i++) {
+                file_.write(units_[i].c_str(), units_[i].size() + 1);
+            }
+            count = (uint32_t)blocks_.size();
+            file_.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            if(!blocks_.empty()) {
+                file_.write(reinterpret_cast<const char*>(&blocks_[0]), blocks_.size() * sizeof(BlockInfo));
+            }
+            file_.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+            file_.write(archive_magic, sizeof(archive_magic));
+            ok = (bool)file_;
+            if(!ok) {
+                error_.message("Unable to write archive footer");
+            }
+        }
+        
+        file_.close();
+        
+        return ok;
+    }
+    
+    // returns the last error message, nullptr if there was none
+    const char* ArchiveWriter::message() const {
+        return error_.message();
+    }
+    
+    // sets object to safe empty state
+    ArchiveReader::ArchiveReader() {
+        
+    }
+    
+    // opens the archive at path and loads its block directory
+    bool ArchiveReader::open(const char* path) {
+        
+        close();
+        
+        file_.open(path, std::ios::in | std::ios::binary);
+        
+        char magic[8];
+        uint64_t footer = 0;
+        
+        file_.seekg(-(std::streamoff)(sizeof(footer) + sizeof(magic)), std::ios::end);
+        file_.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+        file_.read(magic, sizeof(magic));
+        
+        if(!file_ || memcmp(magic, archive_magic, sizeof(magic)) != 0) {
+            close();
+            error_.message("Not an archive file");
+            return false;
+        }
+        
+        file_.seekg(footer);
+        
+        uint32_t count = 0;
+        file_.read(reinterpret_cast<char*>(&count), sizeof(count));
+        
+        for(uint32_t i = 0; i < count && file_; i++) {
+            std::string unit;
+            std::getline(file_, unit, '\0');
+            units_.push_back(unit);
+        }
+        
+        file_.read(reinterpret_cast<char*>(&count), sizeof(count));
+        
+        if(file_) {
+            blocks_.resize(count);
+            if(count > 0) {
+                file_.read(reinterpret_cast<char*>(&blocks_[0]), count * sizeof(BlockInfo));
+            }
+        }
+        
+        if(!file_) {
+            close();
+            error_.message("Archive footer is corrupt");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // closes the archive and returns to safe empty state
+    void ArchiveReader::close() {
+        if(file_.is_open()) {
+            file_.close();
+        }
+        file_.clear();
+        blocks_.clear();
+        units_.clear();
+        error_.clear();
+    }
+    
+    // returns the last error message, nullptr if there was none
+    const char* ArchiveReader::message() const {
+        return error_.message();
+    }
+    
+    // returns the number of blocks in the archive
+    int ArchiveReader::blocks() const {
+        return (int)blocks_.size();
+    }
+    
+    // returns the number of records in the archive
+    long long ArchiveReader::records() const {
+        long long total = 0;
+        for(size_t i = 0; i < blocks_.size(); i++) {
+            total += blocks_[i].count;
+        }
+        return total;
+    }
+    
+    // returns the statistics of a block
+    const BlockStats& ArchiveReader::stats(int block) const {
+        return blocks_[block].stats;
+    }
+    
+    // decodes the selected columns of a block into out, fields of other columns are left empty
+    // only the bytes of the selected columns are read from the file
+    bool ArchiveReader::readBlock(int block, unsigned columns, std::vector<Record>& out) const {
+        
+        if(block < 0 || block >= blocks()) {
+            return false;
+        }
+        
+        const BlockInfo& info = blocks_[block];
+        size_t n = info.count;
+        uint64_t offset = info.offset;
+        std::vector<uint8_t> data;
+        
+        out.resize(n);
+        for(size_t i = 0; i < n; i++) {
+            clear(out[i]);
+        }
+        
+        for(int c = 0; c < archive_columns; c++) {
+            
+            uint64_t start = offset;
+            offset += info.length[c];
+            
+            if((columns & (1u << c)) == 0) {
+                continue;
+            }
+            
+            data.resize(info.length[c]);
+            file_.seekg(start);
+            if(!data.empty()) {
+                file_.read(reinterpret_cast<char*>(&data[0]), data.size());
+            }
+            if(!file_) {
+                file_.clear();
+                return false;
+            }
+            
+            const uint8_t* p = data.data();
+            const uint8_t* end = p + data.size();
+            std::vector<int64_t> values;
+            
+            if(c == 0 && p < end) {
+                if(*p++ == 0) {
+                    BitReader bits(p, end - p);
+                    for(size_t i = 0; i < n; i++) {
+                        out[i].type = bits.read(1) ? 'P' : 'N';
+                    }
+                } else {
+                    for(size_t i = 0; i < n && p < end; i++) {
+                        out[i].type = (char)*p++;
+                    }
+                }
+            } else if(c == 1 || c == 2) {
+                for(size_t i = 0; i < n && p < end; i++) {
+                    const uint8_t* nul = static_cast<const uint8_t*>(memchr(p, '\0', end - p));
+                    size_t length = nul == nullptr ? end - p : nul - p;
+                    char* field = c == 1 ? out[i].sku : out[i].name;
+                    size_t size = c == 1 ? sizeof(out[i].sku) : sizeof(out[i].name);
+                    memcpy(field, p, length < size ? length : size - 1);
+                    p += length + 1;
+                }
+            } else if(c == 3) {
+                if(!decodeFrame(data, n, values)) {
+                    return false;
+                }
+                for(size_t i = 0; i < n; i++) {
+                    if(values[i] >= 0 && values[i] < (int64_t)units_.size()) {
+                        strncpy(out[i].unit, units_[values[i]].c_str(), max_unit_length);
+                    }
+                }
+            } else if(c == 4) {
+                BitReader bits(p, end - p);
+                for(size_t i = 0; i < n; i++) {
+                    out[i].taxed = bits.read(1) != 0;
+                }
+            } else if(c == 5) {
+                for(size_t i = 0; i < n && p + sizeof(double) <= end; i++, p += sizeof(double)) {
+                    memcpy(&out[i].price, p, sizeof(double));
+                }
+            } else if(c == 6 || c == 7) {
+                if(!decodeFrame(data, n, values)) {
+                    return false;
+                }
+                for(size_t i = 0; i < n; i++) {
+                    (c == 6 ? out[i].qty : out[i].qtyNeeded) = (int)values[i];
+                }
+            } else if(c == 8 && p < end) {
+                int width = *p++;
+                BitReader bits(p, end - p);
+                int32_t prev = 0;
+                for(size_t i = 0; i < n; i++) {
+                    uint64_t code = bits.read(width);
+                    if(code != 0) {
+                        prev = (int32_t)(prev + unzigzag(code - 1));
+                        out[i].expiry = prev;
+                    }
+                }
+            }
+        }
+        
+        return true;
+    }
+    
+    // decodes the selected columns of every block accepted by filter and passes each record to visit
+    bool ArchiveReader::scan(unsigned columns, const std::function<bool(const BlockStats&)>& filter, const std::function<bool(const Record&)>& visit) const {
+        
+        std::vector<Record> recs;
+        
+        for(int b = 0; b < blocks(); b++) {
+            
+            if(filter && !filter(blocks_[b].stats)) {
+                continue;
+            }
+            
+            if(!readBlock(b, columns, recs)) {
+                return false;
+            }
+            
+            for(size_t i = 0; i < recs.size(); i++) {
+                if(!visit(recs[i])) {
+                    return true;
+                }
+            }
+        }
+        
+        return true;
+    }
+    
+    // copies every valid record of a file written by store() into a new archive
+    long long archiveFile(const char* storePath, const char* archivePath, int blockSize) {
+        
+        RecordReader reader;
+        ArchiveWriter writer(blockSize);
+        Record rec;
+        long long count = 0;
+        
+        if(!reader.open(storePath) || !writer.open(archivePath)) {
+            return -1;
+        }
+        
+        while(reader.next(rec)) {
+            if(!writer.append(rec)) {
+                return -1;
+            }
+            count++;
+        }
+        
+        return writer.close() ? count : -1;
+    }
+    
+}
@@ -0,0 +1,119 @@
+/* --------------------------------------------
+ Description: This is the header file for Archive.cpp. It declares the columnar archive format for product records: records are grouped into blocks, each field of a block is stored as its own encoded column, and every block carries min/max statistics so a scan can skip it without decoding it.
+ ----------------------------------------------- */
+
+#ifndef AMA_ARCHIVE_H_
+#define AMA_ARCHIVE_H_
+
+#include <stdint.h>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "ErrorState.h"
+#include "Record.h"
+
+namespace AMA {
+    
+    // columns of a block, used as bit flags to select the columns a reader decodes
+    enum ArchiveColumn {
+        col_type = 1 << 0,
+        col_sku = 1 << 1,
+        col_name = 1 << 2,
+        col_unit = 1 << 3,
+        col_taxed = 1 << 4,
+        col_price = 1 << 5,
+        col_qty = 1 << 6,
+        col_qtyNeeded = 1 << 7,
+        col_expiry = 1 << 8,
+        col_all = (1 << 9) - 1
+    };
+    
+    const int archive_columns = 9;
+    const int archive_block_size = 4096;
+    
+    // statistics of one block, expiry limits only cover records with an expiry date
+    struct BlockStats {
+        int32_t minQty;
+        int32_t maxQty;
+        int32_t minQtyNeeded;
+        int32_t maxQtyNeeded;
+        int32_t minExpiry;
+        int32_t maxExpiry;
+        double minPrice;
+        double maxPrice;
+        uint32_t perishables;
+        uint32_t taxed;
+        char minSku[max_sku_length + 1];
+        char maxSku[max_sku_length + 1];
+    };
+    
+    struct BlockInfo {
+        uint64_t offset;                        // file offset of the first column
+        uint32_t count;                         // number of records
+        uint32_t length[archive_columns];       // encoded length of each column
+        BlockStats stats;
+    };
+    
+    class ArchiveWriter {
+        
+        std::fstream file_;
+        int blockSize_;
+        std::vector<Record> pending_;
+        std::vector<BlockInfo> blocks_;
+        std::vector<std::string> units_;
+        std::map<std::string, uint32_t> unitIds_;
+        ErrorState error_;
+        
+        uint32_t unitId(const char* unit);
+        bool writeBlock();
+        
+    public:
+        ArchiveWriter(int blockSize = archive_block_size);
+        ArchiveWriter(const ArchiveWriter&) = delete;
+        ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+        ~ArchiveWriter();
+        
+        bool open(const char* path);
+        bool append(const Record& rec);
+        bool close();
+        const char* message() const;
+        
+    };
+    
+    class ArchiveReader {
+        
+        mutable std::fstream file_;
+        std::vector<BlockInfo> blocks_;
+        std::vector<std::string> units_;
+        ErrorState error_;
+        
+    public:
+        ArchiveReader();
+        ArchiveReader(const ArchiveReader&) = delete;
+        ArchiveReader& operator=(const ArchiveReader&) = delete;
+        
+        bool open(const char* path);
+        void close();
+        const char* message() const;
+        
+        int blocks() const;
+        long long records() const;
+        const BlockStats& stats(int block) const;
+        
+        bool readBlock(int block, unsigned columns, std::vector<Record>& out) const;
+        
+        // decodes the selected columns of every block accepted by filter and passes each record to visit
+        // a null filter accepts every block, visit returns false to stop the scan
+        bool scan(unsigned columns, const std::function<bool(const BlockStats&)>& filter, const std::function<bool(const Record&)>& visit) const;
+        
+    };
+    
+    // copies every valid record of a file written by store() into a new archive
+    // returns the number of records archived, -1 on error
+    long long archiveFile(const char* storePath, const char* archivePath, int blockSize = archive_block_size);
+    
+}
+
+#endif
@@ -0,0 +1,447 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the AsyncReader and AsyncWriter classes. Buffers circulate between a free queue and a full queue, so at most the configured number of buffers is ever allocated however large the file is.
+ ----------------------------------------------- */
+
+#include <atomic>
+#include <string.h>
+#include "AsyncIO.h"
+
+namespace AMA {
+    
+    // records per formatting task in saveProducts()
+    static const int async_chunk = 16384;
+    
+    // returns threads, or the number of hardware threads if threads is not positive
+    static int threadCount(int threads) {
+        if(threads <= 0) {
+            threads = (int)std::thread::hardware_concurrency();
+        }
+        return threads > 0 ? threads : 1;
+    }
+    
+    // sets queue to empty and open
+    BufferQueue::BufferQueue() {
+        closed_ = false;
+    }
+    
+    // adds buf to the back of the queue
+    void BufferQueue::push(IOBuffer* buf) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.push_back(buf);
+        ready_.notify_one();
+    }
+    
+    // removes the buffer at the front, waiting for one if the queue is empty
+    // returns nullptr once the queue is closed and empty
+    IOBuffer* BufferQueue::pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this]() {
+            return !items_.empty() || closed_;
+        });
+        if(items_.empty()) {
+            return nullptr;
+        }
+        IOBuffer* buf = items_.front();
+        items_.pop_front();
+        return buf;
+    }
+    
+    // wakes every waiting pop(), which return nullptr once the queue is empty
+    void BufferQueue::close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        ready_.notify_all();
+    }
+    
+    // empties and reopens the queue
+    void BufferQueue::reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.clear();
+        closed_ = false;
+    }
+    
+    // allocates buffers of bufferSize characters
+    AsyncReader::AsyncReader(size_t bufferSize, int buffers) : buffers_(buffers < 2 ? 2 : buffers) {
+        file_ = nullptr;
+        failed_.store(false, std::memory_order_relaxed);
+        for(size_t i = 0; i < buffers_.size(); i++) {
+            buffers_[i].data.resize(bufferSize < max_record_length ? max_record_length : bufferSize);
+        }
+    }
+    
+    // stops the reader thread
+    AsyncReader::~AsyncReader() {
+        close();
+    }
+    
+    // opens path and starts reading it on the reader thread
+    bool AsyncReader::open(const char* path) {
+        
+        close();
+        
+        file_ = fopen(path, "rb");
+        failed_.store(false, std::memory_order_relaxed);
+        
+        if(file_ == nullptr) {
+            return false;
+        }
+        
+        free_.reset();
+        full_.reset();
+        for(size_t i = 0; i < buffers_.size(); i++) {
+            free_.push(&buffers_[i]);
+        }
+        
+        thread_ = std::thread(&AsyncReader::run, this);
+        
+        return true;
+    }
+    
+    // stops the reader thread, waiting for it to finish the buffer it is filling
+    void AsyncReader::close() {
+        if(thread_.joinable()) {
+            free_.close();
+            full_.close();
+            thread_.join();
+        }
+        if(file_ != nullptr) {
+            fclose(file_);
+        }
+        file_ = nullptr;
+    }
+    
+    // reader thread: fills free buffers with whole lines and queues them in file order
+    void AsyncReader::run() {
+        
+        std::vector<char> carry;                // partial line left at the end of the last buffer
+        IOBuffer* buf = nullptr;
+        long long seq = 0;
+        bool eof = false;
+        
+        while(!eof) {
+            
+            if(buf == nullptr) {
+                buf = free_.pop();
+                if(buf == nullptr) {
+                    break;
+                }
+            }
+            
+            if(buf->data.size() < carry.size() + max_record_length) {
+                buf->data.resize(carry.size() + max_record_length);
+            }
+            
+            if(!carry.empty()) {
+                memcpy(buf->data.data(), carry.data(), carry.size());
+            }
+            size_t size = carry.size();
+            size += fread(buf->data.data() + size, 1, buf->data.size() - size, file_);
+            eof = size < buf->data.size();
+            
+            // a short read is only the end of the file if fread did not fail
+            if(eof && ferror(file_)) {
+                failed_.store(true, std::memory_order_relaxed);
+                break;
+            }
+            
+            // keeps whole lines, the rest moves to the next buffer
+            size_t end = size;
+            if(!eof) {
+                while(end > 0 && buf->data[end - 1] != '\n') {
+                    end--;
+                }
+            }
+            carry.assign(buf->data.begin() + end, buf->data.begin() + size);
+            
+            // a line longer than the buffer grows it and is read again
+            if(end == 0 && !eof) {
+                buf->data.resize(buf->data.size() * 2);
+                continue;
+            }
+            
+            buf->size = end;
+            buf->seq = seq++;
+            full_.push(buf);
+            buf = nullptr;
+        }
+        
+        full_.close();
+    }
+    
+    // returns the next buffer of whole lines, nullptr at end of file
+    IOBuffer* AsyncReader::next() {
+        return full_.pop();
+    }
+    
+    // gives buf back to the reader thread for refilling
+    void AsyncReader::release(IOBuffer* buf) {
+        free_.push(buf);
+    }
+    
+    // returns true if the reader stopped at a read error instead of the end of the file
+    bool AsyncReader::failed() const {
+        return failed_.load(std::memory_order_relaxed);
+    }
+    
+    // allocates buffers of bufferSize characters
+    AsyncWriter::AsyncWriter(size_t bufferSize, int buffers) : buffers_(buffers < 2 ? 2 : buffers) {
+        file_ = nullptr;
+        seq_ = 0;
+        done_ = 0;
+        closing_ = false;
+        failed_ = false;
+        current_ = nullptr;
+        for(size_t i = 0; i < buffers_.size(); i++) {
+            buffers_[i].data.resize(bufferSize < max_record_length ? max_record_length : bufferSize);
+        }
+    }
+    
+    // writes anything still buffered
+    AsyncWriter::~AsyncWriter() {
+        close();
+    }
+    
+    // creates path and starts the writer thread
+    bool AsyncWriter::open(const char* path) {
+        
+        close();
+        
+        file_ = fopen(path, "wb");
+        
+        if(file_ == nullptr) {
+            return false;
+        }
+        
+        free_.reset();
+        for(size_t i = 0; i < buffers_.size(); i++) {
+            free_.push(&buffers_[i]);
+        }
+        seq_ = 0;
+        done_ = 0;
+        closing_ = false;
+        failed_ = false;
+        current_ = nullptr;
+        
+        thread_ = std::thread(&AsyncWriter::run, this);
+        
+        return true;
+    }
+    
+    // writes the remaining buffers and closes the file
+    // returns false if any write failed
+    bool AsyncWriter::close() {
+        
+        if(!thread_.joinable()) {
+            return !failed_;
+        }
+        
+        if(current_ != nullptr) {
+            submit(current_);
+            current_ = nullptr;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closing_ = true;
+            ready_.notify_all();
+        }
+        
+        thread_.join();
+        
+        failed_ = fclose(file_) != 0 || failed_;
+        file_ = nullptr;
+        
+        return !failed_;
+    }
+    
+    // returns an empty buffer, waiting until the writer thread frees one
+    IOBuffer* AsyncWriter::acquire() {
+        std::lock_guard<std::mutex> order(acquire_);
+        IOBuffer* buf = free_.pop();
+        buf->size = 0;
+        buf->seq = seq_++;
+        return buf;
+    }
+    
+    // queues buf for writing after every buffer acquired before it
+    void AsyncWriter::submit(IOBuffer* buf) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        waiting_[buf->seq] = buf;
+        ready_.notify_all();
+    }
+    
+    // appends the store() form of rec, handing the buffer to the writer thread once it is full
+    void AsyncWriter::write(const Record& rec) {
+        if(current_ != nullptr && current_->data.size() - current_->size < (size_t)max_record_length) {
+            submit(current_);
+            current_ = nullptr;
+        }
+        if(current_ == nullptr) {
+            current_ = acquire();
+        }
+        current_->size += formatRecord(rec, current_->data.data() + current_->size);
+    }
+    
+    // writer thread: writes submitted buffers in sequence order and frees them
+    void AsyncWriter::run() {
+        
+        std::unique_lock<std::mutex> lock(mutex_);
+        
+        for(;;) {
+            
+            ready_.wait(lock, [this]() {
+                return (!waiting_.empty() && waiting_.begin()->first == done_) || (closing_ && waiting_.empty());
+            });
+            
+            if(waiting_.empty()) {
+                break;
+            }
+            
+            IOBuffer* buf = waiting_.begin()->second;
+            waiting_.erase(waiting_.begin());
+            done_++;
+            
+            // writes without holding the lock so clients can keep submitting
+            lock.unlock();
+            if(fwrite(buf->data.data(), 1, buf->size, file_) != buf->size) {
+                failed_ = true;
+            }
+            free_.push(buf);
+            lock.lock();
+        }
+    }
+    
+    // frees what a load that hit a read error had already parsed
+    static void discard(std::map<long long, std::vector<Record> >&) {
+    
+    }
+    static void discard(std::map<long long, std::vector<iProduct*> >& parsed) {
+        for(auto it = parsed.begin(); it != parsed.end(); ++it) {
+            for(size_t i = 0; i < it->second.size(); i++) {
+                delete it->second[i];
+            }
+        }
+    }
+    
+    // parses buffers from reader on threads threads and keeps the results in file order
+    template<class T, class Make>
+    static long long loadParallel(const char* path, std::vector<T>& out, int threads, Make make) {
+        
+        AsyncReader reader;
+        std::mutex mutex;
+        std::map<long long, std::vector<T> > parsed;
+        
+        if(!reader.open(path)) {
+            return -1;
+        }
+        
+        auto parser = [&]() {
+            IOBuffer* buf;
+            while((buf = reader.next()) != nullptr) {
+                std::vector<T> part;
+                Record rec;
+                const char* p = buf->data.data();
+                const char* end = p + buf->size;
+                while(p < end) {
+                    const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+                    const char* stop = nl == nullptr ? end : nl;
+                    if(stop > p && parseRecord(p, stop - p, rec)) {
+                        part.push_back(make(rec));
+                    }
+                    p = stop + 1;
+                }
+                long long seq = buf->seq;
+                reader.release(buf);
+                std::lock_guard<std::mutex> lock(mutex);
+                parsed[seq].swap(part);
+            }
+        };
+        
+        std::vector<std::thread> pool;
+        for(int t = 1; t < threadCount(threads); t++) {
+            pool.emplace_back(parser);
+        }
+        parser();
+        for(auto& th : pool) {
+            th.join();
+        }
+        
+        out.clear();
+        if(reader.failed()) {
+            discard(parsed);
+            return -1;
+        }
+        for(auto it = parsed.begin(); it != parsed.end(); ++it) {
+            out.insert(out.end(), it->second.begin(), it->second.end());
+        }
+        
+        return (long long)out.size();
+    }
+    
+    // loads every valid record of a file written by store()
+    long long loadRecords(const char* path, std::vector<Record>& recs, int threads) {
+        return loadParallel(path, recs, threads, [](const Record& rec) {
+            return rec;
+        });
+    }
+    
+    // loads every valid record of a file written by store() as a new Product or Perishable
+    long long loadProducts(const char* path, std::vector<iProduct*>& products, int threads) {
+        return loadParallel(path, products, threads, [](const Record& rec) {
+            return createFromRecord(rec);
+        });
+    }
+    
+    // saves products in the format written by store(), formatting on threads threads
+    bool saveProducts(const char* path, const iProduct* const* products, int count, int threads) {
+        
+        AsyncWriter writer;
+        std::atomic<int> nextChunk(0);
+        std::mutex order;
+        
+        if(!writer.open(path)) {
+            return false;
+        }
+        
+        // the chunk is claimed together with its buffer, so buffers are acquired in chunk order
+        auto formatter = [&]() {
+            for(;;) {
+                IOBuffer* buf;
+                int chunk;
+                {
+                    std::lock_guard<std::mutex> lock(order);
+                    chunk = nextChunk.load();
+                    if(chunk * (long long)async_chunk >= count) {
+                        return;
+                    }
+                    buf = writer.acquire();
+                    nextChunk++;
+                }
+                int from = chunk * async_chunk;
+                int to = from + async_chunk < count ? from + async_chunk : count;
+                Record rec;
+                for(int i = from; i < to; i++) {
+                    if(buf->data.size() - buf->size < (size_t)max_record_length) {
+                        buf->data.resize(buf->data.size() * 2);
+                    }
+                    if(products[i] != nullptr && toRecord(*products[i], rec)) {
+                        buf->size += formatRecord(rec, buf->data.data() + buf->size);
+                    }
+                }
+                writer.submit(buf);
+            }
+        };
+        
+        std::vector<std::thread> pool;
+        for(int t = 1; t < threadCount(threads); t++) {
+            pool.emplace_back(formatter);
+        }
+        formatter();
+        for(auto& th : pool) {
+            th.join();
+        }
+        
+        return writer.close();
+    }
+    
+}
@@ -0,0 +1,123 @@
+/* --------------------------------------------
+ Description: This is the header file for AsyncIO.cpp. It declares the AsyncReader and AsyncWriter classes which move data between a file and a ring of large buffers on their own thread, so parsing and formatting overlap with disk I/O, and the functions that load and save a whole inventory with them.
+ ----------------------------------------------- */
+
+#ifndef AMA_ASYNCIO_H_
+#define AMA_ASYNCIO_H_
+
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Record.h"
+
+namespace AMA {
+    
+    const size_t async_buffer_size = 4 << 20;
+    const int async_buffers = 3;
+    
+    struct IOBuffer {
+        std::vector<char> data;
+        size_t size;                            // characters in use
+        long long seq;                          // position of the buffer in the file
+    };
+    
+    // blocking queue of buffers shared by the I/O thread and its clients
+    class BufferQueue {
+        
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::deque<IOBuffer*> items_;
+        bool closed_;
+        
+    public:
+        BufferQueue();
+        void push(IOBuffer* buf);
+        IOBuffer* pop();
+        void close();
+        void reset();
+        
+    };
+    
+    class AsyncReader {
+        
+        FILE* file_;
+        std::vector<IOBuffer> buffers_;
+        BufferQueue free_;
+        BufferQueue full_;
+        std::atomic<bool> failed_;              // set by the reader thread when fread reports an error
+        std::thread thread_;
+        
+        void run();
+        
+    public:
+        AsyncReader(size_t bufferSize = async_buffer_size, int buffers = async_buffers);
+        AsyncReader(const AsyncReader&) = delete;
+        AsyncReader& operator=(const AsyncReader&) = delete;
+        ~AsyncReader();
+        
+        bool open(const char* path);
+        void close();
+        
+        // returns the next buffer of whole lines, nullptr at end of file
+        // may be called from several threads, each buffer must be given back with release()
+        IOBuffer* next();
+        void release(IOBuffer* buf);
+        
+        // true if a read error ended the file early, checked once next() has returned nullptr
+        bool failed() const;
+        
+    };
+    
+    class AsyncWriter {
+        
+        FILE* file_;
+        std::vector<IOBuffer> buffers_;
+        BufferQueue free_;
+        std::mutex acquire_;                    // guards seq_
+        std::mutex mutex_;                      // guards done_, waiting_ and closing_
+        std::condition_variable ready_;
+        std::map<long long, IOBuffer*> waiting_;
+        long long seq_;                         // sequence number of the next acquired buffer
+        long long done_;                        // sequence number of the next buffer to write
+        bool closing_;
+        bool failed_;
+        IOBuffer* current_;
+        std::thread thread_;
+        
+        void run();
+        
+    public:
+        AsyncWriter(size_t bufferSize = async_buffer_size, int buffers = async_buffers);
+        AsyncWriter(const AsyncWriter&) = delete;
+        AsyncWriter& operator=(const AsyncWriter&) = delete;
+        ~AsyncWriter();
+        
+        bool open(const char* path);
+        bool close();
+        
+        // buffers are written in the order they were acquired, whatever order they are submitted in
+        IOBuffer* acquire();
+        void submit(IOBuffer* buf);
+        
+        // appends to a buffer owned by the writer, for use from a single thread
+        void write(const Record& rec);
+        
+    };
+    
+    // loads every valid record of a file written by store(), parsing buffers on threads parser threads
+    // returns the number of records loaded, -1 if the file cannot be read
+    long long loadRecords(const char* path, std::vector<Record>& recs, int threads = 0);
+    long long loadProducts(const char* path, std::vector<iProduct*>& products, int threads = 0);
+    
+    // saves products in the format written by store(), formatting on threads threads
+    // returns false if the file cannot be written
+    bool saveProducts(const char* path, const iProduct* const* products, int count, int threads = 0);
+    
+}
+
+#endif
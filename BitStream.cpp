@@ -0,0 +1,113 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the BitWriter and BitReader classes. Bits are packed least significant first, one byte at a time, so the packed form is the same on every platform.
+ ----------------------------------------------- */
+
+#include "BitStream.h"
+
+namespace AMA {
+    
+    // appends packed bits to out
+    BitWriter::BitWriter(std::vector<uint8_t>& out) : out_(out) {
+        bits_ = 0;
+        count_ = 0;
+    }
+    
+    // appends the low width bits of value, width is 0 to 64
+    void BitWriter::write(uint64_t value, int width) {
+        while(width > 0) {
+            int take = 8 - count_ < width ? 8 - count_ : width;
+            bits_ |= (value & ((uint64_t(1) << take) - 1)) << count_;
+            value >>= take;
+            width -= take;
+            count_ += take;
+            if(count_ == 8) {
+                out_.push_back((uint8_t)bits_);
+                bits_ = 0;
+                count_ = 0;
+            }
+        }
+    }
+    
+    // writes any pending bits padded with zeros to a full byte
+    void BitWriter::flush() {
+        if(count_ > 0) {
+            out_.push_back((uint8_t)bits_);
+        }
+        bits_ = 0;
+        count_ = 0;
+    }
+    
+    // reads packed bits from size bytes at data
+    BitReader::BitReader(const uint8_t* data, size_t size) {
+        data_ = data;
+        size_ = size;
+        pos_ = 0;
+        bits_ = 0;
+        count_ = 0;
+    }
+    
+    // returns the next width bits, reading zeros past the end of the data
+    uint64_t BitReader::read(int width) {
+        
+        uint64_t value = 0;
+        int filled = 0;
+        
+        while(filled < width) {
+            if(count_ == 0) {
+                bits_ = pos_ < size_ ? data_[pos_] : 0;
+                pos_++;
+                count_ = 8;
+            }
+            int take = width - filled < count_ ? width - filled : count_;
+            value |= (bits_ & ((uint64_t(1) << take) - 1)) << filled;
+            bits_ >>= take;
+            count_ -= take;
+            filled += take;
+        }
+        
+        return value;
+    }
+    
+    // returns the number of bits needed to hold value
+    int bitWidth(uint64_t value) {
+        int width = 0;
+        while(value != 0) {
+            width++;
+            value >>= 1;
+        }
+        return width;
+    }
+    
+    // maps 0, -1, 1, -2 ... to 0, 1, 2, 3 ...
+    uint64_t zigzag(int64_t value) {
+        return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+    }
+    
+    // reverses zigzag()
+    int64_t unzigzag(uint64_t value) {
+        return int64_t(value >> 1) ^ -int64_t(value & 1);
+    }
+    
+    // appends value 7 bits at a time, high bit set on all but the last byte
+    void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while(value >= 0x80) {
+            out.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((uint8_t)value);
+    }
+    
+    // reads a value written by writeVarint() and advances data past it
+    bool readVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for(int shift = 0; data < end && shift < 64; shift += 7) {
+            uint8_t byte = *data++;
+            value |= uint64_t(byte & 0x7f) << shift;
+            if((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+}
@@ -0,0 +1,54 @@
+/* --------------------------------------------
+ Description: This is the header file for BitStream.cpp. It declares the BitWriter and BitReader classes which pack unsigned values of a fixed bit width back to back, and the helpers used to fit signed values and value ranges into as few bits as possible.
+ ----------------------------------------------- */
+
+#ifndef AMA_BITSTREAM_H_
+#define AMA_BITSTREAM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace AMA {
+    
+    class BitWriter {
+        
+        std::vector<uint8_t>& out_;
+        uint64_t bits_;                         // pending bits not yet written to out_
+        int count_;                             // number of pending bits
+        
+    public:
+        explicit BitWriter(std::vector<uint8_t>& out);
+        void write(uint64_t value, int width);
+        void flush();
+        
+    };
+    
+    class BitReader {
+        
+        const uint8_t* data_;
+        size_t size_;
+        size_t pos_;                            // next byte of data_ to load
+        uint64_t bits_;
+        int count_;
+        
+    public:
+        BitReader(const uint8_t* data, size_t size);
+        uint64_t read(int width);
+        
+    };
+    
+    // returns the number of bits needed to hold value
+    int bitWidth(uint64_t value);
+    
+    // maps signed values to unsigned so that values close to zero stay small
+    uint64_t zigzag(int64_t value);
+    int64_t unzigzag(uint64_t value);
+    
+    // writes and reads an unsigned value in 7-bit groups
+    void writeVarint(std::vector<uint8_t>& out, uint64_t value);
+    bool readVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value);
+    
+}
+
+#endif
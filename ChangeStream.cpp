@@ -0,0 +1,148 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the ChangeStream and ChangeSubscriber classes. Each slot is a sequence lock made of atomic words, so subscribers read without locking and detect a slot the producer overwrote while they copied it.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include "ChangeStream.h"
+
+namespace AMA {
+    
+    namespace {
+        
+        std::atomic<ChangeStream*> installed(nullptr);
+        
+        uint64_t bits(double value) {
+            uint64_t word;
+            memcpy(&word, &value, sizeof(word));
+            return word;
+        }
+        
+        double value(uint64_t word) {
+            double d;
+            memcpy(&d, &word, sizeof(d));
+            return d;
+        }
+    
+    }
+    
+    // allocates the ring with every slot marked as never written
+    ChangeStream::ChangeStream(size_t capacity) : head_(0) {
+        size_t size = 1;
+        while(size < capacity) {
+            size <<= 1;
+        }
+        slots_.reset(new Slot[size]);
+        for(size_t i = 0; i < size; i++) {
+            slots_[i].stamp.store(0, std::memory_order_relaxed);
+        }
+        mask_ = size - 1;
+        producer_.clear();
+    }
+    
+    // writes the event into the slot of the next sequence and publishes it
+    uint64_t ChangeStream::publish(const char* sku, ChangeField field, double oldValue, double newValue) {
+        while(producer_.test_and_set(std::memory_order_acquire)) {
+        
+        }
+        
+        uint64_t seq = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[seq & mask_];
+        
+        uint64_t key = 0;
+        if(sku != nullptr) {
+            memcpy(&key, sku, strnlen(sku, max_sku_length));
+        }
+        
+        slot.stamp.store(2 * seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.words[0].store(key, std::memory_order_relaxed);
+        slot.words[1].store((uint64_t)field, std::memory_order_relaxed);
+        slot.words[2].store(bits(oldValue), std::memory_order_relaxed);
+        slot.words[3].store(bits(newValue), std::memory_order_relaxed);
+        slot.stamp.store(2 * seq + 2, std::memory_order_release);
+        head_.store(seq + 1, std::memory_order_release);
+        
+        producer_.clear(std::memory_order_release);
+        return seq;
+    }
+    
+    // returns the sequence the next event will get
+    uint64_t ChangeStream::head() const {
+        return head_.load(std::memory_order_acquire);
+    }
+    
+    size_t ChangeStream::capacity() const {
+        return (size_t)mask_ + 1;
+    }
+    
+    // starts following stream
+    ChangeSubscriber::ChangeSubscriber(const ChangeStream& stream, bool fromOldest) : stream_(&stream), lost_(0) {
+        uint64_t head = stream.head();
+        if(fromOldest) {
+            next_ = head > stream.capacity() ? head - stream.capacity() : 0;
+        } else {
+            next_ = head;
+        }
+    }
+    
+    // copies the next event, jumping to the oldest event still in the ring after an overrun
+    bool ChangeSubscriber::poll(ChangeEvent& ev) {
+        for(;;) {
+            const ChangeStream::Slot& slot = stream_->slots_[next_ & stream_->mask_];
+            uint64_t expected = 2 * next_ + 2;
+            
+            uint64_t before = slot.stamp.load(std::memory_order_acquire);
+            if(before < expected) {
+                return false;
+            }
+            
+            uint64_t words[4];
+            for(int i = 0; i < 4; i++) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = slot.stamp.load(std::memory_order_relaxed);
+            
+            if(before == expected && after == expected) {
+                ev.sequence = next_;
+                memcpy(ev.sku, &words[0], max_sku_length);
+                ev.sku[max_sku_length] = '\0';
+                ev.field = (ChangeField)words[1];
+                ev.oldValue = value(words[2]);
+                ev.newValue = value(words[3]);
+                next_++;
+                return true;
+            }
+            
+            // the producer lapped this subscriber
+            uint64_t head = stream_->head();
+            uint64_t oldest = head > stream_->capacity() ? head - stream_->capacity() : 0;
+            if(oldest <= next_) {
+                oldest = next_ + 1;
+            }
+            lost_ += oldest - next_;
+            next_ = oldest;
+        }
+    }
+    
+    // returns the sequence of the next event poll() returns
+    uint64_t ChangeSubscriber::position() const {
+        return next_;
+    }
+    
+    // returns the number of events overwritten before they were read
+    uint64_t ChangeSubscriber::lost() const {
+        return lost_;
+    }
+    
+    // installs the stream Product mutations are published to
+    void changeStream(ChangeStream* stream) {
+        installed.store(stream, std::memory_order_release);
+    }
+    
+    // returns the installed stream, nullptr when publishing is off
+    ChangeStream* changeStream() {
+        return installed.load(std::memory_order_acquire);
+    }
+    
+}
@@ -0,0 +1,88 @@
+/* --------------------------------------------
+ Description: This is the header file for ChangeStream.cpp. It declares the ChangeStream class, a lock-free ring of product mutation events written by one producer at a time and read by any number of subscribers, and the ChangeSubscriber class which follows the ring from its own position.
+ ----------------------------------------------- */
+
+#ifndef AMA_CHANGESTREAM_H_
+#define AMA_CHANGESTREAM_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include "Product.h"
+
+namespace AMA {
+    
+    const size_t change_capacity = 1 << 16;
+    
+    enum ChangeField {
+        change_quantity,                        // quantity(int) or += changed the quantity on hand
+        change_qtyNeeded,
+        change_price,
+        change_loaded,                          // load() or read() replaced the product, values are the old and new quantity
+        change_cleared                          // setEmpty() cleared the product, values are the old quantity and 0
+    };
+    
+    struct ChangeEvent {
+        uint64_t sequence;
+        char sku[max_sku_length + 1];
+        ChangeField field;
+        double oldValue;
+        double newValue;
+    };
+    
+    class ChangeStream {
+        
+        // stamp is 2 * sequence + 1 while the slot is written and 2 * sequence + 2 once it holds that event
+        struct Slot {
+            std::atomic<uint64_t> stamp;
+            std::atomic<uint64_t> words[4];     // sku, field, old value, new value
+        };
+        
+        std::unique_ptr<Slot[]> slots_;
+        uint64_t mask_;
+        std::atomic<uint64_t> head_;            // sequence of the next event
+        std::atomic_flag producer_;             // keeps concurrent publishers from sharing a slot
+        
+        friend class ChangeSubscriber;
+    
+    public:
+        // capacity is rounded up to a power of two
+        explicit ChangeStream(size_t capacity = change_capacity);
+        ChangeStream(const ChangeStream&) = delete;
+        ChangeStream& operator=(const ChangeStream&) = delete;
+        
+        // appends an event and returns its sequence number, never waits for subscribers
+        uint64_t publish(const char* sku, ChangeField field, double oldValue, double newValue);
+        
+        uint64_t head() const;
+        size_t capacity() const;
+    
+    };
+    
+    class ChangeSubscriber {
+        
+        const ChangeStream* stream_;
+        uint64_t next_;
+        uint64_t lost_;
+    
+    public:
+        // starts at the next event published, or at the oldest event still in the ring
+        explicit ChangeSubscriber(const ChangeStream& stream, bool fromOldest = false);
+        
+        // copies the next event into ev, returns false when the subscriber has caught up
+        // events overwritten before they were read are skipped and counted by lost()
+        bool poll(ChangeEvent& ev);
+        
+        uint64_t position() const;
+        uint64_t lost() const;
+    
+    };
+    
+    // installs the stream Product mutations are published to, nullptr turns publishing off
+    // the stream must stay alive until it is uninstalled
+    void changeStream(ChangeStream* stream);
+    ChangeStream* changeStream();
+    
+}
+
+#endif
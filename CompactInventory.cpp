@@ -0,0 +1,178 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the CompactInventory class. Units come from the unit table shared with Product, or from a table of the inventory's own, so the hot record stores only a 16-bit unit id and grouping by unit is indexed by that id.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include "SkuIndex.h"
+#include "UnitTable.h"
+#include "CompactInventory.h"
+
+namespace AMA {
+    
+    // copies at most size characters of text into field and terminates it
+    static void copyText(char* field, const char* text, size_t size) {
+        size_t length = strnlen(text, size);
+        memcpy(field, text, length);
+        field[length] = '\0';
+    }
+    
+    // sets inventory to safe empty state, interning units into the table shared with Product
+    CompactInventory::CompactInventory() : units_(&units()) {
+        
+    }
+    
+    // sets inventory to safe empty state, interning units into table
+    CompactInventory::CompactInventory(UnitTable& table) : units_(&table) {
+        
+    }
+    
+    // appends rec and returns its position, -1 if its unit does not fit in the unit table
+    int CompactInventory::add(const Record& rec) {
+        
+        uint16_t unit = units_->intern(rec.unit);
+        if(unit == no_unit) {
+            return -1;
+        }
+        
+        HotRecord hot;
+        hot.price = rec.price;
+        hot.qty = rec.qty;
+        hot.qtyNeeded = rec.qtyNeeded;
+        hot.expiry = rec.expiry;
+        hot.unit = unit;
+        hot.type = rec.type;
+        hot.taxed = rec.taxed;
+        hot_.push_back(hot);
+        
+        skus_.push_back(SkuIndex::pack(rec.sku));
+        names_.insert(names_.end(), rec.name, rec.name + max_name_length + 1);
+        
+        return (int)hot_.size() - 1;
+    }
+    
+    // appends a copy of prd and returns its position, -1 if prd is not derived from Product
+    int CompactInventory::add(const iProduct& prd) {
+        Record rec;
+        return toRecord(prd, rec) ? add(rec) : -1;
+    }
+    
+    // replaces the inventory with copies of products, skipping null products and those not derived from Product
+    void CompactInventory::build(const iProduct* const* products, int count) {
+        clear();
+        hot_.reserve(count);
+        skus_.reserve(count);
+        names_.reserve((size_t)count * (max_name_length + 1));
+        for(int i = 0; i < count; i++) {
+            if(products[i] != nullptr) {
+                add(*products[i]);
+            }
+        }
+    }
+    
+    // removes every product
+    void CompactInventory::clear() {
+        hot_.clear();
+        skus_.clear();
+        names_.clear();
+    }
+    
+    // returns the number of products
+    int CompactInventory::size() const {
+        return (int)hot_.size();
+    }
+    
+    // returns the number of bytes allocated by the inventory, not counting its unit table
+    size_t CompactInventory::memoryUsage() const {
+        return hot_.capacity() * sizeof(HotRecord) + skus_.capacity() * sizeof(uint64_t) + names_.capacity();
+    }
+    
+    // returns the hot record of product i
+    const HotRecord& CompactInventory::hot(int i) const {
+        return hot_[i];
+    }
+    
+    // copies the sku of product i into sku, which must hold max_sku_length + 2 characters
+    void CompactInventory::sku(int i, char* sku) const {
+        SkuIndex::unpack(skus_[i], sku);
+    }
+    
+    // returns the name of product i
+    const char* CompactInventory::name(int i) const {
+        return &names_[(size_t)i * (max_name_length + 1)];
+    }
+    
+    // returns the unit of product i
+    const char* CompactInventory::unit(int i) const {
+        return units_->name(hot_[i].unit);
+    }
+    
+    // copies every field of product i into rec
+    void CompactInventory::record(int i, Record& rec) const {
+        
+        const HotRecord& hot = hot_[i];
+        char key[max_sku_length + 2];
+        
+        AMA::clear(rec);
+        sku(i, key);
+        copyText(rec.sku, key, max_sku_length);
+        copyText(rec.name, name(i), max_name_length);
+        copyText(rec.unit, unit(i), max_unit_length);
+        rec.type = hot.type;
+        rec.taxed = hot.taxed;
+        rec.price = hot.price;
+        rec.qty = hot.qty;
+        rec.qtyNeeded = hot.qtyNeeded;
+        rec.expiry = hot.expiry;
+    }
+    
+    // resets number of units on hand of product i
+    void CompactInventory::quantity(int i, int qty) {
+        hot_[i].qty = qty;
+    }
+    
+    // returns total cost of units on hand of product i, as Product::total_cost() does
+    double CompactInventory::total_cost(int i) const {
+        const HotRecord& hot = hot_[i];
+        return (hot.taxed ? hot.price * (1 + tax) : hot.price) * hot.qty;
+    }
+    
+    // returns the total cost of every product, summed in inventory order like valuation()
+    double CompactInventory::valuation() const {
+        double total = 0.0;
+        for(size_t i = 0; i < hot_.size(); i++) {
+            const HotRecord& hot = hot_[i];
+            total += (hot.taxed ? hot.price * (1 + tax) : hot.price) * hot.qty;
+        }
+        return total;
+    }
+    
+    // returns the number of products with fewer units on hand than needed
+    // and appends their positions to found if it is not nullptr
+    int CompactInventory::shortfall(std::vector<int>* found) const {
+        int count = 0;
+        for(size_t i = 0; i < hot_.size(); i++) {
+            if(hot_[i].qty < hot_[i].qtyNeeded) {
+                count++;
+                if(found != nullptr) {
+                    found->push_back((int)i);
+                }
+            }
+        }
+        return count;
+    }
+    
+    // returns the table the unit ids of the inventory belong to
+    const UnitTable& CompactInventory::unitTable() const {
+        return *units_;
+    }
+    
+    // total cost per unit, totals[id] holds the total for unit id
+    void CompactInventory::valuationByUnit(std::vector<double>& totals) const {
+        totals.assign(units_->size(), 0.0);
+        for(size_t i = 0; i < hot_.size(); i++) {
+            const HotRecord& hot = hot_[i];
+            totals[hot.unit] += (hot.taxed ? hot.price * (1 + tax) : hot.price) * hot.qty;
+        }
+    }
+    
+}
@@ -0,0 +1,70 @@
+/* --------------------------------------------
+ Description: This is the header file for CompactInventory.cpp. It declares the CompactInventory class which holds an inventory split into hot and cold parts: the numeric fields used by valuation and shortfall scans sit together in 24-byte records, while skus and names live in separate tables and units are ids in a unit table, the one shared with Product unless the inventory is given its own.
+ ----------------------------------------------- */
+
+#ifndef AMA_COMPACTINVENTORY_H_
+#define AMA_COMPACTINVENTORY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "Record.h"
+
+namespace AMA {
+    
+    class UnitTable;
+    
+    // fields read by scans, packed so that two and a half products fit in a cache line
+    struct HotRecord {
+        double price;
+        int32_t qty;
+        int32_t qtyNeeded;
+        int32_t expiry;                         // Date::dayNumber() of expiry date, 0 if none
+        uint16_t unit;                          // id in the unit table of the inventory
+        char type;
+        bool taxed;
+    };
+    
+    class CompactInventory {
+        
+        std::vector<HotRecord> hot_;
+        std::vector<uint64_t> skus_;            // packed by SkuIndex::pack()
+        std::vector<char> names_;               // max_name_length + 1 characters per product
+        UnitTable* units_;                      // must outlive the inventory
+        
+    public:
+        // units are interned into table, units() by default
+        CompactInventory();
+        explicit CompactInventory(UnitTable& table);
+        
+        // returns the position of the new product, -1 if prd is not a Product or the unit table is full
+        int add(const Record& rec);
+        int add(const iProduct& prd);
+        void build(const iProduct* const* products, int count);
+        void clear();
+        
+        int size() const;
+        size_t memoryUsage() const;
+        
+        const HotRecord& hot(int i) const;
+        void sku(int i, char* sku) const;
+        const char* name(int i) const;
+        const char* unit(int i) const;
+        void record(int i, Record& rec) const;
+        
+        void quantity(int i, int qty);
+        double total_cost(int i) const;
+        
+        // scans that only touch the hot records
+        double valuation() const;
+        int shortfall(std::vector<int>* found = nullptr) const;
+        
+        // total cost per unit, totals[id] holds the total for unit id of unitTable()
+        const UnitTable& unitTable() const;
+        void valuationByUnit(std::vector<double>& totals) const;
+        
+    };
+    
+}
+
+#endif
@@ -0,0 +1,172 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the Consolidator class. Each input is read through its own RecordReader and a heap keyed by packed sku picks the next record, so memory depends only on the number of inputs.
+ ----------------------------------------------- */
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+#include <queue>
+#include "RecordReader.h"
+#include "SkuIndex.h"
+#include "Consolidate.h"
+
+namespace AMA {
+    
+    namespace {
+        
+        // read buffer of each input, kept small because every input has one
+        const size_t input_buffer_size = 256 << 10;
+        
+        struct Input {
+            RecordReader reader;
+            Record rec;
+            uint64_t key;
+            
+            Input() : reader(input_buffer_size) {
+                
+            }
+        };
+        
+        // adds a quantity without overflowing
+        int addQuantity(int total, int qty) {
+            long long sum = (long long)total + qty;
+            return sum > INT_MAX ? INT_MAX : (sum < INT_MIN ? INT_MIN : (int)sum);
+        }
+        
+    }
+    
+    Consolidator::Consolidator() {
+        memset(&stats_, 0, sizeof(stats_));
+    }
+    
+    // merges inputs into output
+    bool Consolidator::run(const std::vector<std::string>& inputs, const char* output,
+                           const std::function<void(const MergeConflict&)>& conflict) {
+        
+        error_.clear();
+        memset(&stats_, 0, sizeof(stats_));
+        
+        std::vector<std::unique_ptr<Input>> files;
+        for(size_t i = 0; i < inputs.size(); i++) {
+            files.push_back(std::unique_ptr<Input>(new Input()));
+            if(!files[i]->reader.open(inputs[i].c_str())) {
+                error_.message("Unable to open inventory file");
+                return false;
+            }
+        }
+        
+        FILE* out = fopen(output, "w");
+        if(out == nullptr) {
+            error_.message("Unable to create consolidated file");
+            return false;
+        }
+        
+        // smallest sku first, then lowest input index, so the first record of a sku comes from the first input
+        typedef std::pair<uint64_t, int> Head;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+        
+        for(size_t i = 0; i < files.size(); i++) {
+            Input& in = *files[i];
+            if(in.reader.next(in.rec)) {
+                in.key = SkuIndex::pack(in.rec.sku);
+                heap.push(Head(in.key, (int)i));
+                stats_.records++;
+            }
+        }
+        
+        std::vector<char> buffer(1 << 20);
+        size_t used = 0;
+        bool ok = true;
+        Record merged;
+        uint64_t mergedKey = 0;
+        unsigned conflicts = 0;
+        
+        // appends merged to the output buffer, writing the buffer out when it is full
+        auto emit = [&]() {
+            if(buffer.size() - used < max_record_length) {
+                ok = ok && fwrite(buffer.data(), 1, used, out) == used;
+                used = 0;
+            }
+            used += formatRecord(merged, &buffer[used]);
+        };
+        
+        while(ok && !heap.empty()) {
+            
+            Head top = heap.top();
+            heap.pop();
+            Input& in = *files[top.second];
+            
+            if(stats_.skus == 0 || top.first != mergedKey) {
+                
+                // writes the sku finished by this one
+                if(stats_.skus > 0) {
+                    emit();
+                }
+                merged = in.rec;
+                mergedKey = top.first;
+                conflicts = 0;
+                stats_.skus++;
+            } else {
+                unsigned fields = compareRecords(merged, in.rec) & conflict_fields;
+                if(fields != 0) {
+                    if(conflicts == 0) {
+                        stats_.conflicts++;
+                    }
+                    conflicts |= fields;
+                    if(conflict) {
+                        MergeConflict c = { fields, &merged, &in.rec, top.second };
+                        conflict(c);
+                    }
+                }
+                merged.qty = addQuantity(merged.qty, in.rec.qty);
+                merged.qtyNeeded = addQuantity(merged.qtyNeeded, in.rec.qtyNeeded);
+                if(in.rec.type == 'P') {
+                    merged.type = 'P';
+                    if(in.rec.expiry != 0 && (merged.expiry == 0 || in.rec.expiry < merged.expiry)) {
+                        merged.expiry = in.rec.expiry;
+                    }
+                }
+            }
+            
+            if(in.reader.next(in.rec)) {
+                uint64_t key = SkuIndex::pack(in.rec.sku);
+                if(key < in.key) {
+                    error_.message("Inventory file is not sorted by sku");
+                    ok = false;
+                }
+                in.key = key;
+                heap.push(Head(key, top.second));
+                stats_.records++;
+            }
+        }
+        
+        if(ok && stats_.skus > 0) {
+            emit();
+        }
+        if(ok && used > 0) {
+            ok = fwrite(buffer.data(), 1, used, out) == used;
+        }
+        if(fclose(out) != 0) {
+            ok = false;
+        }
+        if(!ok && error_.isClear()) {
+            error_.message("Unable to write consolidated file");
+        }
+        
+        for(size_t i = 0; i < files.size(); i++) {
+            stats_.errors += files[i]->reader.errors();
+        }
+        return ok;
+    }
+    
+    const ConsolidateStats& Consolidator::stats() const {
+        return stats_;
+    }
+    
+    // returns the error message of the last failed run, nullptr if there is none
+    const char* Consolidator::message() const {
+        return error_.message();
+    }
+    
+}
@@ -0,0 +1,54 @@
+/* --------------------------------------------
+ Description: This is the header file for Consolidate.cpp. It declares the Consolidator class which merges the sku-sorted inventory files of several warehouses into one file in a single pass: quantities are summed per sku, the earliest expiry date is kept, and skus whose price, taxed flag, unit or type disagree between files are reported as conflicts.
+ ----------------------------------------------- */
+
+#ifndef AMA_CONSOLIDATE_H_
+#define AMA_CONSOLIDATE_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "ErrorState.h"
+#include "Reconcile.h"
+
+namespace AMA {
+    
+    // DiffField bits that make two records of the same sku conflict
+    const unsigned conflict_fields = diff_type | diff_unit | diff_taxed | diff_price;
+    
+    struct MergeConflict {
+        unsigned fields;                        // DiffField bits that differ
+        const Record* kept;                     // record the merged values came from
+        const Record* other;
+        int file;                               // index of the input holding other
+    };
+    
+    struct ConsolidateStats {
+        long long records;                      // records read from every input
+        long long skus;                         // records written
+        long long conflicts;                    // skus with at least one conflict
+        long long errors;                       // lines that did not parse and were dropped
+    };
+    
+    class Consolidator {
+        
+        ConsolidateStats stats_;
+        ErrorState error_;
+        
+    public:
+        Consolidator();
+        
+        // merges inputs, each sorted by sku, into output
+        // the first record of a sku in input order supplies its name, unit, price and taxed flag
+        // conflict is called for every later record of the sku that disagrees with it
+        bool run(const std::vector<std::string>& inputs, const char* output,
+                 const std::function<void(const MergeConflict&)>& conflict = nullptr);
+        
+        const ConsolidateStats& stats() const;
+        const char* message() const;
+        
+    };
+    
+}
+
+#endif
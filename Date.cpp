@@ -255,13 +255,59 @@ namespace AMA {
         return newDate.write(ostr);
     }
     
+    // copy constructor that copies day, month and date from the object referenced
+    Date::Date(const Date& src) {
+        *this = src;
+    }
+    
     // overloaded = operator that copies day, month and date to current object
     Date& Date::operator=(const Date& rhs) {
         this->day = rhs.day;
         this->month = rhs.month;
         this->year = rhs.year;
+        this->comparatorValue = rhs.comparatorValue;
+        this->errorState = rhs.errorState;
         return *this;
     }
+    
+    // returns the number of days since 1970/01/01 for the date, 0 if object is in safe empty state
+    int Date::dayNumber() const {
+        return isSafeEmptyState() ? 0 : daysFromCivil(year, month, day);
+    }
+    
+    // returns the date for a day number produced by dayNumber()
+    // day number 0 returns a date in safe empty state
+    Date Date::fromDayNumber(int days) {
+        Date date;
+        if(days != 0) {
+            civilFromDays(days, date.year, date.month, date.day);
+            date.setComparatorValue();
+        }
+        return date;
+    }
+    
+    // returns the number of days from 1970/01/01 to year/month/day in the proleptic Gregorian calendar
+    int daysFromCivil(int year, int month, int day) {
+        year -= month <= 2;
+        int era = (year >= 0 ? year : year - 399) / 400;
+        int yoe = year - era * 400;
+        int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+    
+    // converts a number of days from 1970/01/01 back into year, month and day
+    void civilFromDays(int days, int& year, int& month, int& day) {
+        days += 719468;
+        int era = (days >= 0 ? days : days - 146096) / 146097;
+        int doe = days - era * 146097;
+        int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        int mp = (5 * doy + 2) / 153;
+        day = doy - (153 * mp + 2) / 5 + 1;
+        month = mp < 10 ? mp + 3 : mp - 9;
+        year = yoe + era * 400 + (month <= 2);
+    }
 
 }
 
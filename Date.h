@@ -45,6 +45,7 @@ namespace AMA {
         // public function declarations
         Date();
         Date(int year, int month, int day);
+        Date(const Date& src);
         
         bool operator==(const Date& rhs) const;
         bool operator!=(const Date& rhs) const;
@@ -61,12 +62,18 @@ namespace AMA {
         std::istream& read(std::istream& istr);
         std::ostream& write(std::ostream& ostr) const;
         
+        int dayNumber() const;
+        static Date fromDayNumber(int days);
+        
     };
    
     // helper function declarations
     std::istream& operator>>(std::istream&, Date&);
     std::ostream& operator<<(std::ostream&, const Date&);
     
+    int daysFromCivil(int year, int month, int day);
+    void civilFromDays(int days, int& year, int& month, int& day);
+    
 }
 
 #endif
@@ -0,0 +1,130 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the EpochDomain and EpochGuard classes. The global epoch only moves forward when every pinned reader has seen it, so an object unlinked in epoch e is unreachable once the epoch reaches e + 2.
+ ----------------------------------------------- */
+
+#include <thread>
+#include "Epoch.h"
+
+namespace AMA {
+    
+    // starts at epoch 1 with every slot free
+    EpochDomain::EpochDomain() : epoch_(1) {
+        for(int i = 0; i < epoch_slots; i++) {
+            slots_[i].epoch.store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    // frees every retired object, no reader may be pinned
+    EpochDomain::~EpochDomain() {
+        for(size_t i = 0; i < retired_.size(); i++) {
+            retired_[i].destroy(retired_[i].ptr);
+        }
+    }
+    
+    // claims a free slot and publishes the current epoch in it
+    int EpochDomain::pin() {
+        
+        // each thread starts at the slot it last claimed, so threads rarely collide
+        static std::atomic<int> threads(0);
+        thread_local int start = threads.fetch_add(1, std::memory_order_relaxed) % epoch_slots;
+        
+        for(;;) {
+            for(int n = 0; n < epoch_slots; n++) {
+                int i = (start + n) % epoch_slots;
+                uint64_t free = 0;
+                uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+                if(slots_[i].epoch.load(std::memory_order_relaxed) == 0 &&
+                   slots_[i].epoch.compare_exchange_strong(free, epoch, std::memory_order_seq_cst)) {
+                    
+                    // the epoch may have moved before the slot was visible to writers
+                    uint64_t now = epoch_.load(std::memory_order_seq_cst);
+                    while(now != epoch) {
+                        slots_[i].epoch.store(now, std::memory_order_seq_cst);
+                        epoch = now;
+                        now = epoch_.load(std::memory_order_seq_cst);
+                    }
+                    start = i;
+                    return i;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+    
+    // releases the slot returned by pin()
+    void EpochDomain::unpin(int slot) {
+        slots_[slot].epoch.store(0, std::memory_order_release);
+    }
+    
+    // moves the epoch forward if every pinned reader is in the current epoch, caller holds mutex_
+    bool EpochDomain::advance() {
+        uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        for(int i = 0; i < epoch_slots; i++) {
+            uint64_t pinned = slots_[i].epoch.load(std::memory_order_seq_cst);
+            if(pinned != 0 && pinned != epoch) {
+                return false;
+            }
+        }
+        epoch_.store(epoch + 1, std::memory_order_seq_cst);
+        return true;
+    }
+    
+    // queues ptr for destruction, every epoch_batch objects frees what has become unreachable
+    void EpochDomain::retire(void* ptr, void (*destroy)(void*)) {
+        size_t waiting;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Retired r = { ptr, destroy, epoch_.load(std::memory_order_seq_cst) };
+            retired_.push_back(r);
+            waiting = retired_.size();
+        }
+        if(waiting % epoch_batch == 0) {
+            collect();
+        }
+    }
+    
+    // frees every object retired at least two epochs ago
+    size_t EpochDomain::collect() {
+        std::vector<Retired> ready;
+        size_t waiting;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(retired_.empty()) {
+                return 0;
+            }
+            
+            // two steps are enough to free everything retired before the call once readers have moved on
+            if(advance()) {
+                advance();
+            }
+            uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+            size_t kept = 0;
+            for(size_t i = 0; i < retired_.size(); i++) {
+                if(retired_[i].epoch + 2 <= epoch) {
+                    ready.push_back(retired_[i]);
+                } else {
+                    retired_[kept++] = retired_[i];
+                }
+            }
+            retired_.resize(kept);
+            waiting = kept;
+        }
+        
+        // destroys outside the lock so writers are not held up by destructors
+        for(size_t i = 0; i < ready.size(); i++) {
+            ready[i].destroy(ready[i].ptr);
+        }
+        return waiting;
+    }
+    
+    // pins the calling thread in domain
+    EpochGuard::EpochGuard(EpochDomain& domain) : domain_(domain), slot_(domain.pin()) {
+        
+    }
+    
+    // unpins the calling thread
+    EpochGuard::~EpochGuard() {
+        domain_.unpin(slot_);
+    }
+    
+}
@@ -0,0 +1,74 @@
+/* --------------------------------------------
+ Description: This is the header file for Epoch.cpp. It declares the EpochDomain class which delays freeing objects unlinked by a writer until no reader that could still hold them remains, and the EpochGuard class which pins a reader for its lifetime.
+ ----------------------------------------------- */
+
+#ifndef AMA_EPOCH_H_
+#define AMA_EPOCH_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace AMA {
+    
+    // number of readers that can be pinned at once, further readers wait for a free slot
+    const int epoch_slots = 128;
+    
+    // retired objects queued between attempts to free them
+    const size_t epoch_batch = 64;
+    
+    class EpochDomain {
+        
+        // 0 while free, otherwise the epoch the reader pinned, padded so readers do not share a cache line
+        struct alignas(64) Slot {
+            std::atomic<uint64_t> epoch;
+        };
+        
+        struct Retired {
+            void* ptr;
+            void (*destroy)(void*);
+            uint64_t epoch;                     // epoch the object was unlinked in
+        };
+        
+        Slot slots_[epoch_slots];
+        std::atomic<uint64_t> epoch_;
+        std::mutex mutex_;                      // guards retired_
+        std::vector<Retired> retired_;
+        
+        bool advance();
+        
+    public:
+        EpochDomain();
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+        ~EpochDomain();
+        
+        // announces a reader and returns its slot, objects it can reach stay alive until unpin()
+        int pin();
+        void unpin(int slot);
+        
+        // frees ptr with destroy once every reader pinned before the call has unpinned
+        void retire(void* ptr, void (*destroy)(void*));
+        
+        // frees what can be freed now and returns the number of objects still waiting
+        size_t collect();
+        
+    };
+    
+    class EpochGuard {
+        
+        EpochDomain& domain_;
+        int slot_;
+        
+    public:
+        explicit EpochGuard(EpochDomain& domain);
+        EpochGuard(const EpochGuard&) = delete;
+        EpochGuard& operator=(const EpochGuard&) = delete;
+        ~EpochGuard();
+        
+    };
+    
+}
+
+#endif
@@ -0,0 +1,105 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the exporters. Every field is written by the export layout of the record schema, so a row costs no stream calls and no printf for ordinary prices; chunks of products are formatted into writer buffers on several threads and the writer puts them in the file in chunk order.
+ ----------------------------------------------- */
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AsyncIO.h"
+#include "Export.h"
+#include "Schema.h"
+
+namespace AMA {
+    
+    // writes rec as a JSON object or CSV row followed by its line break
+    int exportRecord(const Record& rec, ExportFormat format, char* buf) {
+        char* p = buf;
+        if(format == export_json) {
+            *p++ = '{';
+            p = schema::Export::json(rec, p);
+            *p++ = '}';
+            *p++ = '\n';
+        } else {
+            p = schema::Export::csv(rec, p);
+            *p++ = '\r';
+            *p++ = '\n';
+        }
+        return (int)(p - buf);
+    }
+    
+    // writes the CSV header row, nothing for JSON lines
+    int exportHeader(ExportFormat format, char* buf) {
+        if(format == export_json) {
+            return 0;
+        }
+        char* p = schema::Export::header(buf);
+        *p++ = '\r';
+        *p++ = '\n';
+        return (int)(p - buf);
+    }
+    
+    // exports products to path, formatting chunks on threads threads
+    bool exportProducts(const char* path, const iProduct* const* products, int count, ExportFormat format, int threads) {
+        
+        AsyncWriter writer;
+        std::atomic<int> nextChunk(0);
+        std::mutex order;
+        
+        if(!writer.open(path)) {
+            return false;
+        }
+        
+        IOBuffer* header = writer.acquire();
+        header->size = exportHeader(format, header->data.data());
+        writer.submit(header);
+        
+        if(threads <= 0) {
+            threads = (int)std::thread::hardware_concurrency();
+        }
+        if(threads <= 0) {
+            threads = 1;
+        }
+        
+        // the chunk is claimed together with its buffer, so buffers are acquired in chunk order
+        auto formatter = [&]() {
+            for(;;) {
+                IOBuffer* buf;
+                int chunk;
+                {
+                    std::lock_guard<std::mutex> lock(order);
+                    chunk = nextChunk.load();
+                    if(chunk * (long long)export_chunk >= count) {
+                        return;
+                    }
+                    buf = writer.acquire();
+                    nextChunk++;
+                }
+                int from = chunk * export_chunk;
+                int to = from + export_chunk < count ? from + export_chunk : count;
+                Record rec;
+                for(int i = from; i < to; i++) {
+                    if(buf->data.size() - buf->size < (size_t)max_export_length) {
+                        buf->data.resize(buf->data.size() * 2);
+                    }
+                    if(products[i] != nullptr && toRecord(*products[i], rec)) {
+                        buf->size += exportRecord(rec, format, buf->data.data() + buf->size);
+                    }
+                }
+                writer.submit(buf);
+            }
+        };
+        
+        std::vector<std::thread> pool;
+        for(int t = 1; t < threads; t++) {
+            pool.emplace_back(formatter);
+        }
+        formatter();
+        for(auto& th : pool) {
+            th.join();
+        }
+        
+        return writer.close();
+    }
+    
+}
@@ -0,0 +1,37 @@
+/* --------------------------------------------
+ Description: This is the header file for Export.cpp. It declares the functions that export products as JSON lines or RFC 4180 CSV for other systems, formatting straight into large buffers from the record schema and writing them through an AsyncWriter.
+ ----------------------------------------------- */
+
+#ifndef AMA_EXPORT_H_
+#define AMA_EXPORT_H_
+
+#include "Record.h"
+
+namespace AMA {
+    
+    enum ExportFormat {
+        export_json,                            // one JSON object per line, ended by \n
+        export_csv                              // RFC 4180 rows ended by \r\n, after a header row
+    };
+    
+    // longest line written by exportRecord() or exportHeader(), including the line break
+    const int max_export_length = 1024;
+    
+    // products per formatting task in exportProducts()
+    const int export_chunk = 16384;
+    
+    // writes rec into buf as one line of format, buf must hold max_export_length characters
+    // returns the number of characters written
+    int exportRecord(const Record& rec, ExportFormat format, char* buf);
+    
+    // writes the line that starts an export of format, returns the number of characters written
+    // CSV exports start with a row naming the fields, JSON exports start with nothing
+    int exportHeader(ExportFormat format, char* buf);
+    
+    // exports products to the file at path, formatting chunks on threads threads, 0 uses the number of hardware threads
+    // null products and products not derived from Product are skipped, returns false if the file cannot be written
+    bool exportProducts(const char* path, const iProduct* const* products, int count, ExportFormat format, int threads = 0);
+    
+}
+
+#endif
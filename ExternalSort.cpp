@@ -0,0 +1,373 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the ExternalSorter class. Runs are sorted as arrays of pointers so that records are only moved when they are written, spilled runs hold binary records in anonymous temporary files, and the merge keeps one buffered record per run in a heap.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <thread>
+#include "RecordReader.h"
+#include "SkuIndex.h"
+#include "ExternalSort.h"
+
+namespace AMA {
+    
+    namespace {
+        
+        // records read from a spilled run a block at a time
+        class RunReader {
+            
+            FILE* file_;
+            std::vector<Record> buffer_;
+            size_t next_;
+            size_t count_;
+            
+        public:
+            RunReader(FILE* file, size_t records) : file_(file), buffer_(records), next_(0), count_(0) {
+                
+            }
+            
+            // returns the next record of the run, nullptr at its end
+            const Record* next() {
+                if(next_ == count_) {
+                    count_ = fread(buffer_.data(), sizeof(Record), buffer_.size(), file_);
+                    next_ = 0;
+                    if(count_ == 0) {
+                        return nullptr;
+                    }
+                }
+                return &buffer_[next_++];
+            }
+            
+        };
+        
+        // writes records as store() lines or binary records through a large buffer
+        class RunWriter {
+            
+            FILE* file_;
+            bool text_;
+            std::vector<char> buffer_;
+            size_t size_;
+            bool failed_;
+            
+        public:
+            RunWriter(FILE* file, bool text) : file_(file), text_(text), buffer_(1 << 20), size_(0), failed_(false) {
+                
+            }
+            
+            void write(const Record& rec) {
+                if(buffer_.size() - size_ < max_record_length + sizeof(Record)) {
+                    flush();
+                }
+                if(text_) {
+                    size_ += formatRecord(rec, &buffer_[size_]);
+                } else {
+                    memcpy(&buffer_[size_], &rec, sizeof(Record));
+                    size_ += sizeof(Record);
+                }
+            }
+            
+            // returns false if any write failed
+            bool flush() {
+                if(size_ > 0 && fwrite(buffer_.data(), 1, size_, file_) != size_) {
+                    failed_ = true;
+                }
+                size_ = 0;
+                return !failed_;
+            }
+            
+        };
+        
+        // returns the size of the file at path, 0 if it cannot be opened
+        long long fileSize(const char* path) {
+            FILE* file = fopen(path, "rb");
+            if(file == nullptr) {
+                return 0;
+            }
+            fseek(file, 0, SEEK_END);
+            long long size = ftell(file);
+            fclose(file);
+            return size;
+        }
+        
+        double seconds(std::chrono::steady_clock::time_point since) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+        }
+        
+    }
+    
+    // returns true if a sorts before b by key
+    bool lessRecord(const Record& a, const Record& b, SortKey key) {
+        if(key == sort_name) {
+            int order = strcmp(a.name, b.name);
+            if(order != 0) {
+                return order < 0;
+            }
+        } else if(key == sort_expiry && a.expiry != b.expiry) {
+            
+            // day number 0 means no expiry date and sorts after every date
+            return b.expiry == 0 || (a.expiry != 0 && a.expiry < b.expiry);
+        }
+        return strcmp(a.sku, b.sku) < 0;
+    }
+    
+    ExternalSorter::ExternalSorter(size_t memory, int threads) : memory_(memory), threads_(threads) {
+        memset(&stats_, 0, sizeof(stats_));
+    }
+    
+    // stable sorts one piece of order per thread, then merges neighbouring pieces until one is left
+    void ExternalSorter::sortRun(std::vector<const Record*>& order, SortKey key) {
+        
+        auto less = [key](const Record* a, const Record* b) {
+            return lessRecord(*a, *b, key);
+        };
+        
+        int threads = threads_;
+        if(threads <= 0) {
+            threads = (int)std::thread::hardware_concurrency();
+        }
+        if(threads <= 0 || order.size() < 65536) {
+            threads = 1;
+        }
+        
+        std::vector<size_t> bounds;
+        for(int t = 0; t <= threads; t++) {
+            bounds.push_back(order.size() * t / threads);
+        }
+        
+        std::vector<std::thread> pool;
+        for(int t = 1; t < threads; t++) {
+            pool.emplace_back([&order, &bounds, &less, t]() {
+                std::stable_sort(order.begin() + bounds[t], order.begin() + bounds[t + 1], less);
+            });
+        }
+        std::stable_sort(order.begin() + bounds[0], order.begin() + bounds[1], less);
+        for(auto& th : pool) {
+            th.join();
+        }
+        
+        for(size_t width = 1; width < (size_t)threads; width *= 2) {
+            pool.clear();
+            for(size_t t = 0; t + width < (size_t)threads; t += 2 * width) {
+                size_t last = t + 2 * width < (size_t)threads ? t + 2 * width : threads;
+                pool.emplace_back([&order, &bounds, &less, t, width, last]() {
+                    std::inplace_merge(order.begin() + bounds[t], order.begin() + bounds[t + width], order.begin() + bounds[last], less);
+                });
+            }
+            for(auto& th : pool) {
+                th.join();
+            }
+        }
+    }
+    
+    // merges runs into out, earlier runs win ties so the merge is stable, closes every run
+    bool ExternalSorter::merge(std::vector<FILE*>& runs, SortKey key, FILE* out, bool text) {
+        
+        size_t perRun = memory_ / 2 / sizeof(Record) / runs.size();
+        if(perRun < 64) {
+            perRun = 64;
+        }
+        
+        std::vector<RunReader> readers;
+        for(size_t i = 0; i < runs.size(); i++) {
+            rewind(runs[i]);
+            readers.emplace_back(runs[i], perRun);
+        }
+        
+        typedef std::pair<const Record*, size_t> Head;
+        auto after = [key](const Head& a, const Head& b) {
+            if(lessRecord(*b.first, *a.first, key)) {
+                return true;
+            }
+            return !lessRecord(*a.first, *b.first, key) && a.second > b.second;
+        };
+        std::priority_queue<Head, std::vector<Head>, decltype(after)> heap(after);
+        
+        for(size_t i = 0; i < readers.size(); i++) {
+            const Record* rec = readers[i].next();
+            if(rec != nullptr) {
+                heap.push(Head(rec, i));
+            }
+        }
+        
+        RunWriter writer(out, text);
+        while(!heap.empty()) {
+            Head top = heap.top();
+            heap.pop();
+            writer.write(*top.first);
+            const Record* rec = readers[top.second].next();
+            if(rec != nullptr) {
+                heap.push(Head(rec, top.second));
+            }
+        }
+        
+        for(size_t i = 0; i < runs.size(); i++) {
+            fclose(runs[i]);
+        }
+        runs.clear();
+        
+        if(!writer.flush()) {
+            error_.message("Unable to write sorted records");
+            return false;
+        }
+        return true;
+    }
+    
+    // sorts the records of input into output
+    bool ExternalSorter::sort(const char* input, const char* output, SortKey key) {
+        
+        error_.clear();
+        memset(&stats_, 0, sizeof(stats_));
+        
+        RecordReader reader;
+        if(!reader.open(input)) {
+            error_.message("Unable to open inventory file");
+            return false;
+        }
+        
+        size_t capacity = memory_ / (sizeof(Record) + sizeof(const Record*));
+        if(capacity < 1024) {
+            capacity = 1024;
+        }
+        
+        std::vector<Record> records;
+        std::vector<const Record*> order;
+        std::vector<FILE*> runs;
+        bool ok = true;
+        bool more = true;
+        
+        // a run never needs more records than the file can hold, at about 20 characters for the shortest line
+        size_t lines = (size_t)(fileSize(input) / 20 + 1);
+        records.reserve(lines < capacity ? lines : capacity);
+        
+        while(ok && more) {
+            
+            auto start = std::chrono::steady_clock::now();
+            records.clear();
+            Record rec;
+            while(records.size() < capacity && (more = reader.next(rec))) {
+                records.push_back(rec);
+            }
+            stats_.readSeconds += seconds(start);
+            
+            if(records.empty() && !runs.empty()) {
+                break;
+            }
+            
+            start = std::chrono::steady_clock::now();
+            order.resize(records.size());
+            for(size_t i = 0; i < records.size(); i++) {
+                order[i] = &records[i];
+            }
+            sortRun(order, key);
+            stats_.records += records.size();
+            stats_.runs++;
+            
+            // the whole input fit in one run, so it goes straight to the output
+            if(!more && runs.empty()) {
+                stats_.sortSeconds += seconds(start);
+                start = std::chrono::steady_clock::now();
+                FILE* out = fopen(output, "w");
+                if(out == nullptr) {
+                    error_.message("Unable to create sorted file");
+                    return false;
+                }
+                RunWriter writer(out, true);
+                for(size_t i = 0; i < order.size(); i++) {
+                    writer.write(*order[i]);
+                }
+                ok = writer.flush();
+                if(fclose(out) != 0 || !ok) {
+                    error_.message("Unable to write sorted records");
+                    ok = false;
+                }
+                stats_.mergeSeconds += seconds(start);
+                stats_.errors = reader.errors();
+                stats_.bytes = reader.offset();
+                return ok;
+            }
+            
+            FILE* run = tmpfile();
+            if(run == nullptr) {
+                error_.message("Unable to create sort run");
+                ok = false;
+                break;
+            }
+            runs.push_back(run);
+            RunWriter writer(run, false);
+            for(size_t i = 0; i < order.size(); i++) {
+                writer.write(*order[i]);
+            }
+            if(!writer.flush()) {
+                error_.message("Unable to write sort run");
+                ok = false;
+            }
+            stats_.sortSeconds += seconds(start);
+        }
+        
+        stats_.errors = reader.errors();
+        stats_.bytes = reader.offset();
+        reader.close();
+        
+        // releases the run buffer before the merge takes its share of the budget
+        std::vector<Record>().swap(records);
+        std::vector<const Record*>().swap(order);
+        
+        auto start = std::chrono::steady_clock::now();
+        
+        // merges consecutive groups of runs, keeping them in input order, until a single pass can finish the job
+        while(ok && (int)runs.size() > max_merge_ways) {
+            std::vector<FILE*> next;
+            for(size_t first = 0; first < runs.size(); first += max_merge_ways) {
+                size_t last = std::min(first + max_merge_ways, runs.size());
+                std::vector<FILE*> group(runs.begin() + first, runs.begin() + last);
+                FILE* merged = ok ? tmpfile() : nullptr;
+                if(merged == nullptr) {
+                    if(ok) {
+                        error_.message("Unable to create sort run");
+                        ok = false;
+                    }
+                    next.insert(next.end(), group.begin(), group.end());
+                    continue;
+                }
+                next.push_back(merged);
+                ok = merge(group, key, merged, false);
+            }
+            runs.swap(next);
+            stats_.passes++;
+        }
+        
+        if(ok) {
+            FILE* out = fopen(output, "w");
+            if(out == nullptr) {
+                error_.message("Unable to create sorted file");
+                ok = false;
+            } else {
+                ok = merge(runs, key, out, true);
+                if(fclose(out) != 0 && ok) {
+                    error_.message("Unable to write sorted records");
+                    ok = false;
+                }
+                stats_.passes++;
+            }
+        }
+        
+        for(size_t i = 0; i < runs.size(); i++) {
+            fclose(runs[i]);
+        }
+        stats_.mergeSeconds += seconds(start);
+        return ok;
+    }
+    
+    const SortStats& ExternalSorter::stats() const {
+        return stats_;
+    }
+    
+    // returns the error message of the last failed sort, nullptr if there is none
+    const char* ExternalSorter::message() const {
+        return error_.message();
+    }
+    
+}
@@ -0,0 +1,64 @@
+/* --------------------------------------------
+ Description: This is the header file for ExternalSort.cpp. It declares the ExternalSorter class which sorts an inventory file written by store() that may be larger than memory: it reads runs that fit a memory budget, sorts each run on several threads, spills the runs to temporary files and merges them back into one file in store() format.
+ ----------------------------------------------- */
+
+#ifndef AMA_EXTERNALSORT_H_
+#define AMA_EXTERNALSORT_H_
+
+#include <stdio.h>
+#include <vector>
+#include "ErrorState.h"
+#include "Record.h"
+
+namespace AMA {
+    
+    const size_t sort_memory = 256 << 20;
+    
+    // largest number of runs merged at once, more runs are merged in several passes
+    const int max_merge_ways = 128;
+    
+    enum SortKey {
+        sort_sku,
+        sort_name,                              // ties broken by sku
+        sort_expiry                             // ties broken by sku, products without an expiry date last
+    };
+    
+    // returns true if a sorts before b by key
+    bool lessRecord(const Record& a, const Record& b, SortKey key);
+    
+    struct SortStats {
+        long long records;
+        long long bytes;                        // size of the input file
+        long long errors;                       // lines that did not parse and were dropped
+        int runs;
+        int passes;                             // merge passes, 0 when the input fit in one run
+        double readSeconds;                     // reading and parsing the input
+        double sortSeconds;                     // sorting and spilling runs
+        double mergeSeconds;                    // merging and writing the output
+    };
+    
+    class ExternalSorter {
+        
+        size_t memory_;
+        int threads_;
+        SortStats stats_;
+        ErrorState error_;
+        
+        void sortRun(std::vector<const Record*>& order, SortKey key);
+        bool merge(std::vector<FILE*>& runs, SortKey key, FILE* out, bool text);
+        
+    public:
+        // memory bounds the records held at once, threads 0 uses every hardware thread
+        ExternalSorter(size_t memory = sort_memory, int threads = 0);
+        
+        // writes the records of input to output in key order, the sort is stable
+        bool sort(const char* input, const char* output, SortKey key);
+        
+        const SortStats& stats() const;
+        const char* message() const;
+        
+    };
+    
+}
+
+#endif
@@ -0,0 +1,439 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the QuantityHistory class. Each value after the first sample of a block is written as a zigzag number behind a prefix of up to four one bits that selects its width, so an unchanged quantity or a timestamp at the same interval as the one before costs a single bit. Range queries skip whole blocks by their first and last time.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include "BitStream.h"
+#include "History.h"
+#include "SkuIndex.h"
+
+namespace AMA {
+    
+    namespace {
+        
+        // widths selected by the prefixes 10, 110, 1110 and 1111, a 0 prefix means the value is 0
+        const int time_widths[4] = { 7, 12, 20, 64 };
+        const int value_widths[4] = { 6, 13, 20, 33 };
+        
+        // first value of a file written by save()
+        const uint32_t history_magic = 0x484d4141;
+        
+        void encode(BitWriter& out, uint64_t value, const int* widths) {
+            if(value == 0) {
+                out.write(0, 1);
+                return;
+            }
+            for(int i = 0; i < 4; i++) {
+                if(i == 3 || value < (uint64_t(1) << widths[i])) {
+                    // i one bits, then a zero unless the prefix is already four bits long
+                    out.write((uint64_t(1) << (i + 1)) - 1, i + 1);
+                    if(i < 3) {
+                        out.write(0, 1);
+                    }
+                    out.write(value, widths[i]);
+                    return;
+                }
+            }
+        }
+        
+        uint64_t decode(BitReader& in, const int* widths) {
+            int ones = 0;
+            while(ones < 4 && in.read(1) == 1) {
+                ones++;
+            }
+            return ones == 0 ? 0 : in.read(widths[ones - 1]);
+        }
+        
+        void writeSigned(std::vector<uint8_t>& out, int64_t value) {
+            writeVarint(out, zigzag(value));
+        }
+        
+        bool readSigned(const uint8_t*& data, const uint8_t* end, int64_t& value) {
+            uint64_t raw;
+            if(!readVarint(data, end, raw)) {
+                return false;
+            }
+            value = unzigzag(raw);
+            return true;
+        }
+        
+        // returns the day of a time, rounding times before 1970 down
+        int dayOf(int64_t time) {
+            return (int)(time >= 0 ? time / seconds_per_day : (time - seconds_per_day + 1) / seconds_per_day);
+        }
+    
+    }
+    
+    QuantityHistory::QuantityHistory() {
+    
+    }
+    
+    // packs count samples, the first into the block fields and the rest into bits
+    void QuantityHistory::pack(const HistorySample* samples, int count, Block& block) {
+        block.first = samples[0].time;
+        block.last = samples[count - 1].time;
+        block.qty = samples[0].qty;
+        block.qtyNeeded = samples[0].qtyNeeded;
+        block.count = count;
+        block.bits.clear();
+        BitWriter out(block.bits);
+        int64_t delta = 0;
+        for(int i = 1; i < count; i++) {
+            int64_t next = samples[i].time - samples[i - 1].time;
+            encode(out, zigzag(next - delta), time_widths);
+            encode(out, zigzag((int64_t)samples[i].qty - samples[i - 1].qty), value_widths);
+            encode(out, zigzag((int64_t)samples[i].qtyNeeded - samples[i - 1].qtyNeeded), value_widths);
+            delta = next;
+        }
+        out.flush();
+        block.bits.shrink_to_fit();
+    }
+    
+    // visits the samples of a block in order, false if visit stopped
+    bool QuantityHistory::unpack(const Block& block, const std::function<bool(const HistorySample&)>& visit) {
+        HistorySample sample = { block.first, block.qty, block.qtyNeeded };
+        if(!visit(sample)) {
+            return false;
+        }
+        BitReader in(block.bits.data(), block.bits.size());
+        int64_t delta = 0;
+        for(int i = 1; i < block.count; i++) {
+            delta += unzigzag(decode(in, time_widths));
+            sample.time += delta;
+            sample.qty = (int)(sample.qty + unzigzag(decode(in, value_widths)));
+            sample.qtyNeeded = (int)(sample.qtyNeeded + unzigzag(decode(in, value_widths)));
+            if(!visit(sample)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // returns the series of sku, nullptr if it has none
+    const QuantityHistory::Series* QuantityHistory::find(const char* sku) const {
+        auto it = series_.find(SkuIndex::pack(sku));
+        return it == series_.end() ? nullptr : &it->second;
+    }
+    
+    // adds a sample, packing the open samples of sku once they fill a block
+    bool QuantityHistory::append(const char* sku, int64_t time, int qty, int qtyNeeded) {
+        
+        if(sku == nullptr || sku[0] == '\0') {
+            return false;
+        }
+        
+        Series& series = series_[SkuIndex::pack(sku)];
+        
+        int64_t latest = !series.open.empty() ? series.open.back().time : !series.blocks.empty() ? series.blocks.back().last : time;
+        if(time < latest) {
+            return false;
+        }
+        
+        HistorySample sample = { time, qty, qtyNeeded };
+        series.open.push_back(sample);
+        
+        if(series.open.size() == (size_t)history_block_samples) {
+            series.blocks.emplace_back();
+            pack(series.open.data(), (int)series.open.size(), series.blocks.back());
+            series.open.clear();
+        }
+        
+        return true;
+    }
+    
+    // turns quantity changes into samples, carrying the other quantity over from the last sample of the sku
+    long long QuantityHistory::record(ChangeSubscriber& subscriber, int64_t time) {
+        
+        ChangeEvent ev;
+        HistorySample last;
+        long long added = 0;
+        
+        while(subscriber.poll(ev)) {
+            
+            if(ev.field != change_quantity && ev.field != change_qtyNeeded && ev.field != change_loaded && ev.field != change_cleared) {
+                continue;
+            }
+            
+            bool known = at(ev.sku, INT64_MAX, last);
+            int qty = known ? last.qty : 0;
+            int qtyNeeded = known ? last.qtyNeeded : 0;
+            
+            if(ev.field == change_qtyNeeded) {
+                qtyNeeded = (int)ev.newValue;
+            } else {
+                qty = (int)ev.newValue;
+            }
+            
+            if(!known || qty != last.qty || qtyNeeded != last.qtyNeeded) {
+                added += append(ev.sku, known && time < last.time ? last.time : time, qty, qtyNeeded);
+            }
+        }
+        
+        return added;
+    }
+    
+    // packs every open sample
+    void QuantityHistory::seal() {
+        for(auto& entry : series_) {
+            Series& series = entry.second;
+            if(!series.open.empty()) {
+                series.blocks.emplace_back();
+                pack(series.open.data(), (int)series.open.size(), series.blocks.back());
+                series.open.clear();
+                series.open.shrink_to_fit();
+            }
+        }
+    }
+    
+    // decodes only the blocks that overlap [from, to]
+    void QuantityHistory::range(const char* sku, int64_t from, int64_t to, const std::function<bool(const HistorySample&)>& visit) const {
+        
+        const Series* series = find(sku);
+        if(series == nullptr || from > to) {
+            return;
+        }
+        
+        auto block = std::lower_bound(series->blocks.begin(), series->blocks.end(), from, [](const Block& b, int64_t t) {
+            return b.last < t;
+        });
+        
+        bool more = true;
+        for(; more && block != series->blocks.end() && block->first <= to; ++block) {
+            more = unpack(*block, [&](const HistorySample& sample) {
+                if(sample.time > to) {
+                    return false;
+                }
+                return sample.time < from || visit(sample);
+            });
+        }
+        
+        for(size_t i = 0; more && i < series->open.size() && series->open[i].time <= to; i++) {
+            if(series->open[i].time >= from) {
+                more = visit(series->open[i]);
+            }
+        }
+    }
+    
+    // finds the last sample at or before time
+    bool QuantityHistory::at(const char* sku, int64_t time, HistorySample& sample) const {
+        
+        const Series* series = find(sku);
+        if(series == nullptr) {
+            return false;
+        }
+        
+        if(!series->open.empty() && series->open.front().time <= time) {
+            auto it = std::upper_bound(series->open.begin(), series->open.end(), time, [](int64_t t, const HistorySample& s) {
+                return t < s.time;
+            });
+            sample = *(it - 1);
+            return true;
+        }
+        
+        // the last block that starts at or before time
+        auto block = std::upper_bound(series->blocks.begin(), series->blocks.end(), time, [](int64_t t, const Block& b) {
+            return t < b.first;
+        });
+        if(block == series->blocks.begin()) {
+            return false;
+        }
+        --block;
+        
+        unpack(*block, [&](const HistorySample& s) {
+            if(s.time > time) {
+                return false;
+            }
+            sample = s;
+            return true;
+        });
+        return true;
+    }
+    
+    // groups the samples of each day from first to last
+    void QuantityHistory::rollup(const char* sku, const Date& first, const Date& last, const std::function<bool(const DailyRollup&)>& visit) const {
+        
+        int from = first.dayNumber();
+        int to = last.dayNumber();
+        if(from == 0 || to == 0) {
+            return;
+        }
+        
+        DailyRollup day;
+        day.samples = 0;
+        bool more = true;
+        
+        range(sku, from * seconds_per_day, (to + 1) * seconds_per_day - 1, [&](const HistorySample& s) {
+            int d = dayOf(s.time);
+            if(day.samples > 0 && d != day.day) {
+                more = visit(day);
+                day.samples = 0;
+                if(!more) {
+                    return false;
+                }
+            }
+            if(day.samples == 0) {
+                day.day = d;
+                day.first = s.qty;
+                day.min = s.qty;
+                day.max = s.qty;
+            }
+            day.samples++;
+            day.last = s.qty;
+            day.min = std::min(day.min, s.qty);
+            day.max = std::max(day.max, s.qty);
+            day.qtyNeeded = s.qtyNeeded;
+            return true;
+        });
+        
+        if(more && day.samples > 0) {
+            visit(day);
+        }
+    }
+    
+    HistoryStats QuantityHistory::stats() const {
+        HistoryStats stats;
+        memset(&stats, 0, sizeof(stats));
+        for(auto& entry : series_) {
+            const Series& series = entry.second;
+            stats.skus++;
+            stats.blocks += (long long)series.blocks.size();
+            for(size_t i = 0; i < series.blocks.size(); i++) {
+                stats.samples += series.blocks[i].count;
+                stats.packedBytes += series.blocks[i].bits.size();
+            }
+            stats.samples += (long long)series.open.size();
+            stats.openBytes += series.open.size() * sizeof(HistorySample);
+        }
+        return stats;
+    }
+    
+    // counts the hash table, the block headers, the packed bits and the open buffers
+    size_t QuantityHistory::memoryUsage() const {
+        size_t bytes = series_.bucket_count() * sizeof(void*);
+        for(auto& entry : series_) {
+            const Series& series = entry.second;
+            bytes += sizeof(entry) + 2 * sizeof(void*);
+            bytes += series.blocks.capacity() * sizeof(Block) + series.open.capacity() * sizeof(HistorySample);
+            for(size_t i = 0; i < series.blocks.size(); i++) {
+                bytes += series.blocks[i].bits.capacity();
+            }
+        }
+        return bytes;
+    }
+    
+    // writes a header, then each series as its key, its blocks and its open samples packed into one more block
+    bool QuantityHistory::save(const char* path) const {
+        
+        error_.clear();
+        
+        std::fstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!file) {
+            error_.message("Cannot create history file");
+            return false;
+        }
+        
+        std::vector<uint8_t> out;
+        writeVarint(out, history_magic);
+        writeVarint(out, series_.size());
+        
+        Block open;
+        for(auto& entry : series_) {
+            const Series& series = entry.second;
+            writeVarint(out, entry.first);
+            writeVarint(out, series.blocks.size() + (series.open.empty() ? 0 : 1));
+            for(size_t i = 0; i <= series.blocks.size(); i++) {
+                const Block* block = i < series.blocks.size() ? &series.blocks[i] : nullptr;
+                if(block == nullptr) {
+                    if(series.open.empty()) {
+                        break;
+                    }
+                    pack(series.open.data(), (int)series.open.size(), open);
+                    block = &open;
+                }
+                writeSigned(out, block->first);
+                writeSigned(out, block->last - block->first);
+                writeSigned(out, block->qty);
+                writeSigned(out, block->qtyNeeded);
+                writeVarint(out, (uint64_t)block->count);
+                writeVarint(out, block->bits.size());
+                out.insert(out.end(), block->bits.begin(), block->bits.end());
+            }
+            if(out.size() >= (1 << 20)) {
+                file.write(reinterpret_cast<const char*>(out.data()), out.size());
+                out.clear();
+            }
+        }
+        
+        file.write(reinterpret_cast<const char*>(out.data()), out.size());
+        file.close();
+        if(file.fail()) {
+            error_.message("Cannot write history file");
+            return false;
+        }
+        return true;
+    }
+    
+    // replaces every series with those in path
+    bool QuantityHistory::load(const char* path) {
+        
+        error_.clear();
+        
+        std::fstream file(path, std::ios::in | std::ios::binary);
+        if(!file) {
+            error_.message("Cannot open history file");
+            return false;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        
+        const uint8_t* p = data.data();
+        const uint8_t* end = p + data.size();
+        uint64_t magic, count;
+        
+        // every series takes at least two bytes, so a larger count cannot come from save()
+        if(!readVarint(p, end, magic) || magic != history_magic || !readVarint(p, end, count) || count > (uint64_t)(end - p) / 2) {
+            error_.message("Not a history file");
+            return false;
+        }
+        
+        std::unordered_map<uint64_t, Series> loaded;
+        loaded.reserve(count);
+        
+        for(uint64_t s = 0; s < count; s++) {
+            uint64_t key, blocks;
+            if(!readVarint(p, end, key) || !readVarint(p, end, blocks)) {
+                error_.message("History file is truncated");
+                return false;
+            }
+            Series& series = loaded[key];
+            for(uint64_t b = 0; b < blocks; b++) {
+                Block block;
+                int64_t first, span, qty, qtyNeeded;
+                uint64_t samples, size;
+                if(!readSigned(p, end, first) || !readSigned(p, end, span) || !readSigned(p, end, qty) || !readSigned(p, end, qtyNeeded) ||
+                   !readVarint(p, end, samples) || !readVarint(p, end, size) || size > (uint64_t)(end - p) ||
+                   samples == 0 || samples > (uint64_t)history_block_samples) {
+                    error_.message("History file is truncated");
+                    return false;
+                }
+                block.first = first;
+                block.last = first + span;
+                block.qty = (int)qty;
+                block.qtyNeeded = (int)qtyNeeded;
+                block.count = (int)samples;
+                block.bits.assign(p, p + size);
+                p += size;
+                series.blocks.push_back(std::move(block));
+            }
+        }
+        
+        series_.swap(loaded);
+        return true;
+    }
+    
+    const char* QuantityHistory::message() const {
+        return error_.message();
+    }
+    
+}
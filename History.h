@@ -0,0 +1,107 @@
+/* --------------------------------------------
+ Description: This is the header file for History.cpp. It declares the QuantityHistory class, an append-only time series of the quantity on hand and quantity needed of each sku. Samples are kept raw until their block fills or is sealed, then packed into a block of bits: timestamps as deltas of deltas and quantities as deltas, each in a prefix-coded width, so a sku that changes at a steady pace costs a few bits per sample.
+ ----------------------------------------------- */
+
+#ifndef AMA_HISTORY_H_
+#define AMA_HISTORY_H_
+
+#include <stdint.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "ChangeStream.h"
+#include "Date.h"
+#include "ErrorState.h"
+
+namespace AMA {
+    
+    // samples packed into one block
+    const int history_block_samples = 256;
+    
+    const int64_t seconds_per_day = 86400;
+    
+    struct HistorySample {
+        int64_t time;                           // seconds since 1970/01/01, the epoch of Date::dayNumber()
+        int qty;
+        int qtyNeeded;
+    };
+    
+    // the samples of one sku on one day
+    struct DailyRollup {
+        int day;                                // Date::dayNumber() of the day
+        int samples;
+        int first;                              // quantity on hand at the first and last sample of the day
+        int last;
+        int min;
+        int max;
+        int qtyNeeded;                          // quantity needed at the last sample of the day
+    };
+    
+    struct HistoryStats {
+        long long skus;
+        long long samples;
+        long long blocks;
+        size_t packedBytes;                     // bits of the packed blocks
+        size_t openBytes;                       // samples not packed yet
+    };
+    
+    class QuantityHistory {
+        
+        struct Block {
+            int64_t first;                      // time of the first and last sample
+            int64_t last;
+            int qty;                            // values of the first sample, the bits hold the rest
+            int qtyNeeded;
+            int count;
+            std::vector<uint8_t> bits;
+        };
+        
+        struct Series {
+            std::vector<Block> blocks;
+            std::vector<HistorySample> open;
+        };
+        
+        std::unordered_map<uint64_t, Series> series_;
+        mutable ErrorState error_;
+        
+        static void pack(const HistorySample* samples, int count, Block& block);
+        static bool unpack(const Block& block, const std::function<bool(const HistorySample&)>& visit);
+        const Series* find(const char* sku) const;
+        
+    public:
+        QuantityHistory();
+        QuantityHistory(const QuantityHistory&) = delete;
+        QuantityHistory& operator=(const QuantityHistory&) = delete;
+        
+        // adds a sample to the series of sku, false if it is older than the last sample of sku
+        bool append(const char* sku, int64_t time, int qty, int qtyNeeded);
+        
+        // appends the quantity changes published since the subscriber last polled, all at time
+        // returns the number of samples added
+        long long record(ChangeSubscriber& subscriber, int64_t time);
+        
+        // packs every sample not packed yet, so the open buffers do not hold memory between bursts
+        void seal();
+        
+        // visits the samples of sku with from <= time <= to in time order, visit returns false to stop
+        void range(const char* sku, int64_t from, int64_t to, const std::function<bool(const HistorySample&)>& visit) const;
+        
+        // finds the last sample of sku at or before time, false if there is none
+        bool at(const char* sku, int64_t time, HistorySample& sample) const;
+        
+        // visits one rollup for each day from first to last that has samples of sku
+        void rollup(const char* sku, const Date& first, const Date& last, const std::function<bool(const DailyRollup&)>& visit) const;
+        
+        HistoryStats stats() const;
+        size_t memoryUsage() const;
+        
+        // writes every series to path and reads it back, samples not packed yet are packed in the file
+        bool save(const char* path) const;
+        bool load(const char* path);
+        const char* message() const;
+        
+    };
+    
+}
+
+#endif
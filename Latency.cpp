@@ -0,0 +1,275 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the LatencyHistogram and LatencyTimer classes and the per-thread recorders behind them. Each thread records into a block of atomic counters that only it writes, so recording is a pair of clock reads and two plain stores. Blocks are kept on a lock-free list that readers walk to merge, and a block is handed to a new thread when the thread that owned it exits.
+ ----------------------------------------------- */
+
+#include <atomic>
+#include <iomanip>
+#include "Latency.h"
+
+namespace AMA {
+    
+    // the counters of one thread, written by that thread only
+    struct LatencyRecorder {
+        struct Op {
+            std::atomic<uint64_t> counts[latency_buckets];
+            std::atomic<uint64_t> count;
+            std::atomic<uint64_t> sum;
+            std::atomic<uint64_t> max;
+        };
+        Op ops[latency_ops];
+        unsigned active;                        // bit per operation the owning thread is timing
+        std::atomic<bool> owned;
+        LatencyRecorder* next;                  // set before the recorder is published, never changed
+    };
+    
+    namespace {
+        
+        const int half_bucket = 1 << (latency_sub_bits - 1);
+        
+        std::atomic<bool> enabled(false);
+        
+        std::atomic<LatencyRecorder*> recorders(nullptr);
+        
+        void empty(LatencyRecorder::Op& op) {
+            for(int i = 0; i < latency_buckets; i++) {
+                op.counts[i].store(0, std::memory_order_relaxed);
+            }
+            op.count.store(0, std::memory_order_relaxed);
+            op.sum.store(0, std::memory_order_relaxed);
+            op.max.store(0, std::memory_order_relaxed);
+        }
+        
+        // takes a recorder left by a thread that exited, or publishes a new one
+        LatencyRecorder* acquire() {
+            for(LatencyRecorder* r = recorders.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+                if(!r->owned.load(std::memory_order_relaxed) && !r->owned.exchange(true, std::memory_order_acquire)) {
+                    return r;
+                }
+            }
+            LatencyRecorder* r = new LatencyRecorder;
+            for(int i = 0; i < latency_ops; i++) {
+                empty(r->ops[i]);
+            }
+            r->active = 0;
+            r->owned.store(true, std::memory_order_relaxed);
+            r->next = recorders.load(std::memory_order_relaxed);
+            while(!recorders.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {
+            
+            }
+            return r;
+        }
+        
+        // gives the recorder of an exiting thread back, its counts stay in the totals
+        struct Owner {
+            LatencyRecorder* recorder = nullptr;
+            ~Owner() {
+                if(recorder != nullptr) {
+                    recorder->active = 0;
+                    recorder->owned.store(false, std::memory_order_release);
+                }
+            }
+        };
+        
+        thread_local Owner owner;
+        
+        LatencyRecorder& local() {
+            if(owner.recorder == nullptr) {
+                owner.recorder = acquire();
+            }
+            return *owner.recorder;
+        }
+        
+        // adds to a counter only the calling thread writes, so no read-modify-write instruction is needed
+        void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+        
+        void record(LatencyRecorder& r, LatencyOp op, uint64_t nanos) {
+            LatencyRecorder::Op& counters = r.ops[op];
+            bump(counters.counts[LatencyHistogram::bucketOf(nanos)], 1);
+            bump(counters.count, 1);
+            bump(counters.sum, nanos);
+            if(nanos > counters.max.load(std::memory_order_relaxed)) {
+                counters.max.store(nanos, std::memory_order_relaxed);
+            }
+        }
+        
+        const char* const names[latency_ops] = { "load", "store", "read", "write", "lookup" };
+    
+    }
+    
+    LatencyHistogram::LatencyHistogram() : counts_(latency_buckets, 0), count_(0), sum_(0), max_(0) {
+    
+    }
+    
+    // returns the bucket that counts nanos
+    int LatencyHistogram::bucketOf(uint64_t nanos) {
+        if(nanos < (1u << latency_sub_bits)) {
+            return (int)nanos;
+        }
+        int top = 63 - __builtin_clzll(nanos);
+        if(top >= latency_max_bits) {
+            return latency_buckets - 1;
+        }
+        int shift = top - latency_sub_bits + 1;
+        return (1 << latency_sub_bits) + (shift - 1) * half_bucket + (int)(nanos >> shift) - half_bucket;
+    }
+    
+    // returns the longest duration counted in bucket
+    uint64_t LatencyHistogram::upperBound(int bucket) {
+        if(bucket < (1 << latency_sub_bits)) {
+            return (uint64_t)bucket;
+        }
+        int shift = (bucket - (1 << latency_sub_bits)) / half_bucket + 1;
+        uint64_t mantissa = (uint64_t)((bucket - (1 << latency_sub_bits)) % half_bucket + half_bucket);
+        return ((mantissa + 1) << shift) - 1;
+    }
+    
+    void LatencyHistogram::record(uint64_t nanos) {
+        counts_[bucketOf(nanos)]++;
+        count_++;
+        sum_ += nanos;
+        if(nanos > max_) {
+            max_ = nanos;
+        }
+    }
+    
+    void LatencyHistogram::merge(const LatencyHistogram& other) {
+        for(int i = 0; i < latency_buckets; i++) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        if(other.max_ > max_) {
+            max_ = other.max_;
+        }
+    }
+    
+    void LatencyHistogram::clear() {
+        counts_.assign(latency_buckets, 0);
+        count_ = 0;
+        sum_ = 0;
+        max_ = 0;
+    }
+    
+    uint64_t LatencyHistogram::count() const {
+        return count_;
+    }
+    
+    uint64_t LatencyHistogram::max() const {
+        return max_;
+    }
+    
+    double LatencyHistogram::mean() const {
+        return count_ == 0 ? 0 : (double)sum_ / count_;
+    }
+    
+    // walks the buckets until percent of the durations are behind, never reports more than the longest duration
+    uint64_t LatencyHistogram::percentile(double percent) const {
+        if(count_ == 0) {
+            return 0;
+        }
+        uint64_t target = (uint64_t)(percent / 100 * count_ + 0.5);
+        if(target < 1) {
+            target = 1;
+        } else if(target > count_) {
+            target = count_;
+        }
+        uint64_t seen = 0;
+        for(int i = 0; i < latency_buckets; i++) {
+            seen += counts_[i];
+            if(seen >= target) {
+                return i == latency_buckets - 1 || upperBound(i) > max_ ? max_ : upperBound(i);
+            }
+        }
+        return max_;
+    }
+    
+    // starts the clock when op should be counted
+    LatencyTimer::LatencyTimer(LatencyOp op) : op_(op), recorder_(nullptr) {
+        if(!enabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+        LatencyRecorder& r = local();
+        if((r.active & (1u << op)) == 0) {
+            r.active |= 1u << op;
+            recorder_ = &r;
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+    
+    // stops the clock and counts the duration
+    LatencyTimer::~LatencyTimer() {
+        if(recorder_ != nullptr) {
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start_;
+            recorder_->active &= ~(1u << op_);
+            record(*recorder_, op_, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+    
+    const char* latencyOpName(LatencyOp op) {
+        return op >= 0 && op < latency_ops ? names[op] : "unknown";
+    }
+    
+    void latencyEnabled(bool on) {
+        enabled.store(on, std::memory_order_relaxed);
+    }
+    
+    bool latencyEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    
+    // counts one duration of op in the histogram of the calling thread
+    void recordLatency(LatencyOp op, uint64_t nanos) {
+        if(op >= 0 && op < latency_ops) {
+            record(local(), op, nanos);
+        }
+    }
+    
+    // sums the counters of every recorder, including those of threads that exited
+    void latencySnapshot(LatencyOp op, LatencyHistogram& out) {
+        out.clear();
+        if(op < 0 || op >= latency_ops) {
+            return;
+        }
+        for(LatencyRecorder* r = recorders.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            const LatencyRecorder::Op& counters = r->ops[op];
+            for(int i = 0; i < latency_buckets; i++) {
+                out.counts_[i] += counters.counts[i].load(std::memory_order_relaxed);
+            }
+            out.count_ += counters.count.load(std::memory_order_relaxed);
+            out.sum_ += counters.sum.load(std::memory_order_relaxed);
+            uint64_t max = counters.max.load(std::memory_order_relaxed);
+            if(max > out.max_) {
+                out.max_ = max;
+            }
+        }
+    }
+    
+    // empties every recorder, a thread recording meanwhile may write back a count it read before the reset
+    void latencyReset() {
+        for(LatencyRecorder* r = recorders.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            for(int i = 0; i < latency_ops; i++) {
+                empty(r->ops[i]);
+            }
+        }
+    }
+    
+    // writes one line per operation that has durations
+    std::ostream& latencyReport(std::ostream& os) {
+        LatencyHistogram histogram;
+        os << std::left << std::setw(8) << "op" << std::right << std::setw(12) << "count" << std::setw(10) << "p50"
+        << std::setw(10) << "p99" << std::setw(10) << "p999" << std::setw(12) << "max" << '\n';
+        for(int i = 0; i < latency_ops; i++) {
+            latencySnapshot((LatencyOp)i, histogram);
+            if(histogram.count() == 0) {
+                continue;
+            }
+            os << std::left << std::setw(8) << latencyOpName((LatencyOp)i) << std::right << std::setw(12) << histogram.count()
+            << std::setw(10) << histogram.percentile(50) << std::setw(10) << histogram.percentile(99)
+            << std::setw(10) << histogram.percentile(99.9) << std::setw(12) << histogram.max() << '\n';
+        }
+        return os;
+    }
+    
+}
@@ -0,0 +1,100 @@
+/* --------------------------------------------
+ Description: This is the header file for Latency.cpp. It declares the LatencyHistogram class, a log-linear histogram of durations in nanoseconds in the style of HdrHistogram, and the LatencyTimer class which times one record or inventory operation into a histogram owned by the calling thread. Threads record without locking or sharing cache lines, and latencySnapshot() merges every thread's histogram without stopping them.
+ ----------------------------------------------- */
+
+#ifndef AMA_LATENCY_H_
+#define AMA_LATENCY_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace AMA {
+    
+    enum LatencyOp {
+        latency_load,                           // Product::load() and Perishable::load()
+        latency_store,
+        latency_read,
+        latency_write,
+        latency_lookup,                         // SkuIndex::find(), which every inventory lookup goes through
+        latency_ops
+    };
+    
+    // durations below 2 ^ latency_sub_bits are counted exactly, longer ones to within 1 part in 2 ^ (latency_sub_bits - 1)
+    const int latency_sub_bits = 6;
+    
+    // durations of 2 ^ latency_max_bits nanoseconds or more are counted in the last bucket
+    const int latency_max_bits = 40;
+    
+    const int latency_buckets = (1 << latency_sub_bits) + (latency_max_bits - latency_sub_bits) * (1 << (latency_sub_bits - 1));
+    
+    struct LatencyRecorder;
+    
+    class LatencyHistogram {
+        
+        std::vector<uint64_t> counts_;
+        uint64_t count_;
+        uint64_t sum_;
+        uint64_t max_;
+        
+    public:
+        LatencyHistogram();
+        
+        static int bucketOf(uint64_t nanos);
+        
+        // returns the longest duration counted in bucket
+        static uint64_t upperBound(int bucket);
+        
+        void record(uint64_t nanos);
+        void merge(const LatencyHistogram& other);
+        void clear();
+        
+        uint64_t count() const;
+        uint64_t max() const;
+        double mean() const;
+        
+        // returns the duration at or below which percent of the durations fall, 0 when empty
+        uint64_t percentile(double percent) const;
+        
+        friend void latencySnapshot(LatencyOp op, LatencyHistogram& out);
+        
+    };
+    
+    class LatencyTimer {
+        
+        std::chrono::steady_clock::time_point start_;
+        LatencyOp op_;
+        LatencyRecorder* recorder_;             // counters of the calling thread, nullptr when op is not timed
+        
+    public:
+        // starts timing op unless recording is off or the thread is already timing op, so
+        // Perishable::load() calling Product::load() is counted once
+        explicit LatencyTimer(LatencyOp op);
+        LatencyTimer(const LatencyTimer&) = delete;
+        LatencyTimer& operator=(const LatencyTimer&) = delete;
+        ~LatencyTimer();
+        
+    };
+    
+    const char* latencyOpName(LatencyOp op);
+    
+    // turns recording on or off for every thread, recording is off until it is turned on
+    void latencyEnabled(bool enabled);
+    bool latencyEnabled();
+    
+    // counts one duration of op in the histogram of the calling thread
+    void recordLatency(LatencyOp op, uint64_t nanos);
+    
+    // replaces out with the sum of every thread's histogram for op
+    void latencySnapshot(LatencyOp op, LatencyHistogram& out);
+    
+    // empties every thread's histograms, durations recorded during the call may survive it
+    void latencyReset();
+    
+    // writes one line per operation with its count, p50, p99, p999 and max in nanoseconds
+    std::ostream& latencyReport(std::ostream& os);
+    
+}
+
+#endif
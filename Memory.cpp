@@ -0,0 +1,144 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the MemoryReport class and the allocation counters. The counters are constant initialized, so the hook can count allocations made before any other static object is constructed.
+ ----------------------------------------------- */
+
+#include <atomic>
+#include <iomanip>
+#include "Memory.h"
+#include "Perishable.h"
+
+namespace AMA {
+    
+    namespace {
+        
+        std::atomic<bool> hooked(false);
+        std::atomic<long long> allocations(0);
+        std::atomic<long long> frees(0);
+        std::atomic<long long> liveBytes(0);
+        
+        // writes one row of the report
+        void row(std::ostream& os, const char* name, const MemoryUsage& usage) {
+            os << std::left << std::setw(12) << name << std::right << std::setw(12) << usage.count
+            << std::setw(8) << (usage.count == 0 ? 0 : usage.total() / usage.count)
+            << std::setw(14) << usage.vtables << std::setw(14) << usage.fields << std::setw(14) << usage.names
+            << std::setw(14) << usage.messages << std::setw(14) << usage.dates << std::setw(14) << usage.total() << '\n';
+        }
+    
+    }
+    
+    size_t MemoryUsage::total() const {
+        return vtables + fields + names + messages + dates;
+    }
+    
+    // sets every count to 0
+    void clear(MemoryUsage& usage) {
+        usage.count = 0;
+        usage.vtables = 0;
+        usage.fields = 0;
+        usage.names = 0;
+        usage.messages = 0;
+        usage.dates = 0;
+        usage.blocks = 0;
+    }
+    
+    MemoryReport::MemoryReport() {
+        clear(products_);
+        clear(perishables_);
+        clear(others_);
+    }
+    
+    // adds product to the breakdown of its kind, counting only the size of objects of unknown kinds
+    void MemoryReport::account(const iProduct& product) {
+        const Product* prd = dynamic_cast<const Product*>(&product);
+        if(prd == nullptr) {
+            others_.count++;
+            others_.vtables += sizeof(void*);
+            others_.fields += sizeof(iProduct) - sizeof(void*);
+        } else {
+            prd->memoryUsage(dynamic_cast<const Perishable*>(prd) != nullptr ? perishables_ : products_);
+        }
+    }
+    
+    void MemoryReport::account(const iProduct* const* products, int count) {
+        for(int i = 0; i < count; i++) {
+            if(products[i] != nullptr) {
+                account(*products[i]);
+            }
+        }
+    }
+    
+    void MemoryReport::index(const char* name, size_t bytes) {
+        Index entry = { name == nullptr ? "" : name, bytes };
+        indexes_.push_back(entry);
+    }
+    
+    const MemoryUsage& MemoryReport::products() const {
+        return products_;
+    }
+    
+    const MemoryUsage& MemoryReport::perishables() const {
+        return perishables_;
+    }
+    
+    size_t MemoryReport::indexBytes() const {
+        size_t bytes = 0;
+        for(size_t i = 0; i < indexes_.size(); i++) {
+            bytes += indexes_[i].bytes;
+        }
+        return bytes;
+    }
+    
+    size_t MemoryReport::total() const {
+        return products_.total() + perishables_.total() + others_.total() + indexBytes();
+    }
+    
+    // writes the report as a table in bytes
+    std::ostream& MemoryReport::write(std::ostream& os) const {
+        os << std::left << std::setw(12) << "kind" << std::right << std::setw(12) << "count" << std::setw(8) << "each"
+        << std::setw(14) << "vtables" << std::setw(14) << "fields" << std::setw(14) << "names"
+        << std::setw(14) << "messages" << std::setw(14) << "dates" << std::setw(14) << "total" << '\n';
+        row(os, "product", products_);
+        row(os, "perishable", perishables_);
+        if(others_.count != 0) {
+            row(os, "other", others_);
+        }
+        for(size_t i = 0; i < indexes_.size(); i++) {
+            os << std::left << std::setw(12) << indexes_[i].name << std::right << std::setw(110) << indexes_[i].bytes << '\n';
+        }
+        os << std::left << std::setw(12) << "total" << std::right << std::setw(110) << total() << '\n';
+        if(allocationHookInstalled()) {
+            AllocationStats stats = allocationStats();
+            os << std::left << std::setw(12) << "heap" << std::right << std::setw(12) << stats.live << " live allocations"
+            << std::setw(81) << stats.liveBytes << '\n';
+        }
+        return os;
+    }
+    
+    bool allocationHookInstalled() {
+        return hooked.load(std::memory_order_relaxed);
+    }
+    
+    // reads the counters one at a time, so they can be slightly apart while other threads allocate
+    AllocationStats allocationStats() {
+        AllocationStats stats;
+        stats.allocations = allocations.load(std::memory_order_relaxed);
+        stats.frees = frees.load(std::memory_order_relaxed);
+        stats.live = stats.allocations - stats.frees;
+        stats.liveBytes = liveBytes.load(std::memory_order_relaxed);
+        return stats;
+    }
+    
+    void countAllocation(size_t bytes) {
+        if(!hooked.load(std::memory_order_relaxed)) {
+            hooked.store(true, std::memory_order_relaxed);
+        }
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        liveBytes.fetch_add((long long)bytes, std::memory_order_relaxed);
+    }
+    
+    void countFree(size_t bytes) {
+        frees.fetch_add(1, std::memory_order_relaxed);
+        liveBytes.fetch_sub((long long)bytes, std::memory_order_relaxed);
+    }
+    
+}
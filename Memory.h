@@ -0,0 +1,80 @@
+/* --------------------------------------------
+ Description: This is the header file for Memory.cpp. It declares the MemoryUsage breakdown of one kind of product, the MemoryReport class which adds up the products and indexes of an inventory, and the counters kept by the optional allocation hook in AllocHook.cpp.
+ ----------------------------------------------- */
+
+#ifndef AMA_MEMORY_H_
+#define AMA_MEMORY_H_
+
+#include <stddef.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "iProduct.h"
+
+namespace AMA {
+    
+    // bytes held by a number of products of one kind, filled by Product::memoryUsage()
+    struct MemoryUsage {
+        long long count;
+        size_t vtables;                         // vtable pointers
+        size_t fields;                          // inline fields and padding: type, sku, unit id, name pointer, quantities, price
+        size_t names;                           // heap buffers holding the names
+        size_t messages;                        // std::string objects, plus the heap text of messages too long to keep inline
+        size_t dates;                           // expiry dates of Perishable products
+        long long blocks;                       // heap allocations behind the names and messages
+        
+        size_t total() const;
+    };
+    
+    void clear(MemoryUsage& usage);
+    
+    class MemoryReport {
+        
+        struct Index {
+            std::string name;
+            size_t bytes;
+        };
+        
+        MemoryUsage products_;
+        MemoryUsage perishables_;
+        MemoryUsage others_;                    // iProduct implementations that do not derive from Product
+        std::vector<Index> indexes_;
+        
+    public:
+        MemoryReport();
+        
+        // adds the products to the breakdown of their kind
+        void account(const iProduct& product);
+        void account(const iProduct* const* products, int count);
+        
+        // adds a structure kept beside the products, such as a SkuIndex or the UnitTable
+        void index(const char* name, size_t bytes);
+        
+        const MemoryUsage& products() const;
+        const MemoryUsage& perishables() const;
+        size_t indexBytes() const;
+        size_t total() const;
+        
+        // writes one line per kind of product and per index, followed by the totals
+        std::ostream& write(std::ostream& os) const;
+        
+    };
+    
+    struct AllocationStats {
+        long long allocations;                  // calls to operator new
+        long long frees;                        // calls to operator delete with a non-null pointer
+        long long live;                         // allocations not freed yet
+        long long liveBytes;                    // bytes requested by those allocations
+    };
+    
+    // true once a program linked with the allocation hook has allocated, the counters stay 0 otherwise
+    bool allocationHookInstalled();
+    AllocationStats allocationStats();
+    
+    // called by the replacement operator new and delete in AllocHook.cpp
+    void countAllocation(size_t bytes);
+    void countFree(size_t bytes);
+    
+}
+
+#endif
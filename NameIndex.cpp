@@ -0,0 +1,287 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the NameIndex class. A single edit changes at most three trigrams of a name, so a fuzzy lookup only verifies names that share enough trigrams with the query, and falls back to a length filtered scan when the query is too short for that bound to help.
+ ----------------------------------------------- */
+
+#include <algorithm>
+#include <string.h>
+#include "SkuIndex.h"
+#include "NameIndex.h"
+
+namespace AMA {
+    
+    // returns the trigram at position i of name padded with two leading and one trailing marker
+    static uint32_t trigram(const char* name, int length, int i) {
+        uint32_t gram = 0;
+        for(int k = i - 2; k <= i; k++) {
+            unsigned char ch = k < 0 ? 1 : (k >= length ? 2 : (unsigned char)name[k]);
+            gram = (gram << 8) | ch;
+        }
+        return gram;
+    }
+    
+    // returns the edit distance between a and b, or limit + 1 once it is known to exceed limit
+    static int editDistance(const char* a, int la, const char* b, int lb, int limit) {
+        
+        int row[max_name_length + 2];
+        
+        if(la - lb > limit || lb - la > limit) {
+            return limit + 1;
+        }
+        
+        for(int j = 0; j <= lb; j++) {
+            row[j] = j;
+        }
+        
+        for(int i = 1; i <= la; i++) {
+            int diagonal = row[0];
+            int best = row[0] = i;
+            for(int j = 1; j <= lb; j++) {
+                int above = row[j];
+                int cost = diagonal + (a[i - 1] != b[j - 1]);
+                cost = std::min(cost, std::min(above, row[j - 1]) + 1);
+                row[j] = cost;
+                diagonal = above;
+                best = std::min(best, cost);
+            }
+            if(best > limit) {
+                return limit + 1;
+            }
+        }
+        
+        return row[lb];
+    }
+    
+    // sets index to safe empty state
+    NameIndex::NameIndex() {
+        live_ = 0;
+    }
+    
+    // orders ids by name
+    bool NameIndex::lessId(uint32_t a, uint32_t b) const {
+        return strcmp(entries_[a].name, entries_[b].name) < 0;
+    }
+    
+    // adds the trigrams of entry id to the inverted index
+    void NameIndex::addGrams(uint32_t id) {
+        const char* name = entries_[id].name;
+        int length = (int)strlen(name);
+        for(int i = 0; i <= length; i++) {
+            std::vector<uint32_t>& list = grams_[trigram(name, length, i)];
+            // a name repeating a trigram is listed once
+            if(list.empty() || list.back() != id) {
+                list.push_back(id);
+            }
+        }
+    }
+    
+    // replaces the index with the names of products
+    void NameIndex::build(const iProduct* const* products, int count) {
+        
+        clear();
+        
+        for(int i = 0; i < count; i++) {
+            const Product* prd = dynamic_cast<const Product*>(products[i]);
+            if(prd != nullptr) {
+                NameEntry ent;
+                const char* nm = products[i]->name();
+                strncpy(ent.name, nm == nullptr ? "" : nm, max_name_length);
+                ent.name[max_name_length] = '\0';
+                ent.live = true;
+                ent.sku = SkuIndex::pack(prd->sku());
+                entries_.push_back(ent);
+                addGrams((uint32_t)entries_.size() - 1);
+            }
+        }
+        
+        live_ = entries_.size();
+        sorted_.resize(entries_.size());
+        for(size_t i = 0; i < sorted_.size(); i++) {
+            sorted_[i] = (uint32_t)i;
+        }
+        std::stable_sort(sorted_.begin(), sorted_.end(), [this](uint32_t a, uint32_t b) {
+            return lessId(a, b);
+        });
+    }
+    
+    // adds name for the product with sku
+    void NameIndex::insert(const char* name, const char* sku) {
+        
+        NameEntry ent;
+        strncpy(ent.name, name, max_name_length);
+        ent.name[max_name_length] = '\0';
+        ent.live = true;
+        ent.sku = SkuIndex::pack(sku);
+        entries_.push_back(ent);
+        
+        uint32_t id = (uint32_t)entries_.size() - 1;
+        addGrams(id);
+        live_++;
+        
+        pending_.insert(std::upper_bound(pending_.begin(), pending_.end(), id, [this](uint32_t a, uint32_t b) {
+            return lessId(a, b);
+        }), id);
+        
+        if(pending_.size() >= pending_limit) {
+            merge();
+        }
+    }
+    
+    // moves the recent inserts into the main array
+    void NameIndex::merge() {
+        size_t middle = sorted_.size();
+        sorted_.insert(sorted_.end(), pending_.begin(), pending_.end());
+        std::inplace_merge(sorted_.begin(), sorted_.begin() + middle, sorted_.end(), [this](uint32_t a, uint32_t b) {
+            return lessId(a, b);
+        });
+        pending_.clear();
+    }
+    
+    // removes the entry for name and sku, its slot stays allocated until the next build()
+    // returns false if there is no such entry
+    bool NameIndex::remove(const char* name, const char* sku) {
+        
+        uint64_t key = SkuIndex::pack(sku);
+        
+        for(int pass = 0; pass < 2; pass++) {
+            const std::vector<uint32_t>& ids = pass == 0 ? sorted_ : pending_;
+            auto it = std::lower_bound(ids.begin(), ids.end(), name, [this](uint32_t id, const char* nm) {
+                return strcmp(entries_[id].name, nm) < 0;
+            });
+            for(; it != ids.end() && strcmp(entries_[*it].name, name) == 0; ++it) {
+                if(entries_[*it].live && entries_[*it].sku == key) {
+                    entries_[*it].live = false;
+                    live_--;
+                    return true;
+                }
+            }
+        }
+        
+        return false;
+    }
+    
+    // removes every entry
+    void NameIndex::clear() {
+        entries_.clear();
+        sorted_.clear();
+        pending_.clear();
+        grams_.clear();
+        live_ = 0;
+    }
+    
+    // returns the number of live entries
+    size_t NameIndex::size() const {
+        return live_;
+    }
+    
+    // returns an estimate of the bytes allocated by the index
+    size_t NameIndex::memoryUsage() const {
+        size_t bytes = entries_.capacity() * sizeof(NameEntry) + (sorted_.capacity() + pending_.capacity()) * sizeof(uint32_t);
+        // one hash node per trigram plus its bucket pointer
+        bytes += grams_.bucket_count() * sizeof(void*);
+        for(auto it = grams_.begin(); it != grams_.end(); ++it) {
+            bytes += sizeof(*it) + sizeof(void*) + it->second.capacity() * sizeof(uint32_t);
+        }
+        return bytes;
+    }
+    
+    // appends skus of live names equal to, or starting with, the first length characters of prefix
+    void NameIndex::scan(const char* prefix, size_t length, bool exact, std::vector<uint64_t>& skus, size_t limit) const {
+        
+        skus.clear();
+        
+        for(int pass = 0; pass < 2; pass++) {
+            const std::vector<uint32_t>& ids = pass == 0 ? sorted_ : pending_;
+            auto it = std::lower_bound(ids.begin(), ids.end(), prefix, [this](uint32_t id, const char* nm) {
+                return strcmp(entries_[id].name, nm) < 0;
+            });
+            for(; it != ids.end() && strncmp(entries_[*it].name, prefix, length) == 0; ++it) {
+                const NameEntry& ent = entries_[*it];
+                if(exact && ent.name[length] != '\0') {
+                    break;
+                }
+                if(ent.live) {
+                    skus.push_back(ent.sku);
+                    if(limit != 0 && skus.size() >= limit) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+    
+    // finds products with exactly this name
+    void NameIndex::exact(const char* name, std::vector<uint64_t>& skus, size_t limit) const {
+        // stored names are cut to max_name_length characters, so the query is cut the same way before seeking
+        char cut[max_name_length + 1];
+        size_t length = std::min(strlen(name), (size_t)max_name_length);
+        memcpy(cut, name, length);
+        cut[length] = '\0';
+        scan(cut, length, true, skus, limit);
+    }
+    
+    // finds products whose name starts with prefix
+    void NameIndex::prefix(const char* prefix, std::vector<uint64_t>& skus, size_t limit) const {
+        scan(prefix, strlen(prefix), false, skus, limit);
+    }
+    
+    // finds names within maxEdits insertions, deletions or substitutions of name, closest first
+    void NameIndex::fuzzy(const char* name, int maxEdits, std::vector<uint64_t>& skus, size_t limit) const {
+        
+        int length = (int)strlen(name);
+        std::vector<std::pair<int, uint32_t> > found;
+        
+        // a trigram repeated in the query is counted once, as names list each of theirs once
+        std::vector<uint32_t> grams;
+        for(int i = 0; i <= length; i++) {
+            uint32_t gram = trigram(name, length, i);
+            if(std::find(grams.begin(), grams.end(), gram) == grams.end()) {
+                grams.push_back(gram);
+            }
+        }
+        
+        // each edit removes at most three trigram positions, so at most three distinct trigrams
+        int needed = (int)grams.size() - 3 * maxEdits;
+        
+        skus.clear();
+        
+        auto verify = [&](uint32_t id) {
+            const NameEntry& ent = entries_[id];
+            if(ent.live) {
+                int distance = editDistance(name, length, ent.name, (int)strlen(ent.name), maxEdits);
+                if(distance <= maxEdits) {
+                    found.push_back(std::make_pair(distance, id));
+                }
+            }
+        };
+        
+        if(needed <= 0) {
+            // too few trigrams survive that many edits to narrow the search
+            for(uint32_t id = 0; id < entries_.size(); id++) {
+                verify(id);
+            }
+        } else {
+            std::unordered_map<uint32_t, int> shared;
+            for(uint32_t gram : grams) {
+                auto list = grams_.find(gram);
+                if(list == grams_.end()) {
+                    continue;
+                }
+                for(uint32_t id : list->second) {
+                    shared[id]++;
+                }
+            }
+            for(auto it = shared.begin(); it != shared.end(); ++it) {
+                if(it->second >= needed) {
+                    verify(it->first);
+                }
+            }
+        }
+        
+        std::sort(found.begin(), found.end());
+        
+        for(size_t i = 0; i < found.size() && (limit == 0 || i < limit); i++) {
+            skus.push_back(entries_[found[i].second].sku);
+        }
+    }
+    
+}
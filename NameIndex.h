@@ -0,0 +1,60 @@
+/* --------------------------------------------
+ Description: This is the header file for NameIndex.cpp. It declares the NameIndex class which finds products by name: exact and prefix lookups use a sorted array of names and typo tolerant lookups use an inverted index of name trigrams. Lookups return skus packed by SkuIndex::pack().
+ ----------------------------------------------- */
+
+#ifndef AMA_NAMEINDEX_H_
+#define AMA_NAMEINDEX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <unordered_map>
+#include <vector>
+#include "Product.h"
+
+namespace AMA {
+    
+    class NameIndex {
+        
+        struct NameEntry {
+            char name[max_name_length + 1];
+            bool live;
+            uint64_t sku;
+        };
+        
+        std::vector<NameEntry> entries_;        // every entry ever added, position is its id
+        std::vector<uint32_t> sorted_;          // ids in name order
+        std::vector<uint32_t> pending_;         // ids of recent inserts in name order
+        std::unordered_map<uint32_t, std::vector<uint32_t> > grams_;
+        size_t live_;
+        
+        bool lessId(uint32_t a, uint32_t b) const;
+        void addGrams(uint32_t id);
+        void merge();
+        void scan(const char* prefix, size_t length, bool exact, std::vector<uint64_t>& skus, size_t limit) const;
+        
+    public:
+        
+        // largest number of inserts kept apart from the main array
+        static const size_t pending_limit = 4096;
+        
+        NameIndex();
+        
+        void build(const iProduct* const* products, int count);
+        void insert(const char* name, const char* sku);
+        bool remove(const char* name, const char* sku);
+        void clear();
+        
+        size_t size() const;
+        size_t memoryUsage() const;
+        
+        void exact(const char* name, std::vector<uint64_t>& skus, size_t limit = 0) const;
+        void prefix(const char* prefix, std::vector<uint64_t>& skus, size_t limit = 0) const;
+        
+        // finds names within maxEdits insertions, deletions or substitutions of name, closest first
+        void fuzzy(const char* name, int maxEdits, std::vector<uint64_t>& skus, size_t limit = 0) const;
+        
+    };
+    
+}
+
+#endif
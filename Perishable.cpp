@@ -8,6 +8,9 @@
 #include <string.h>
 #include <cstring>
 #include "Perishable.h"
+#include "Latency.h"
+#include "Memory.h"
+#include "Schema.h"
 
 
 namespace AMA {
@@ -17,10 +20,23 @@ namespace AMA {
 
     }
     
+    // calls constructor in Product with the type received
+    Perishable::Perishable(char type) : Product(type) {
+        
+    }
+    
+    // returns the address of a new Perishable object
+    iProduct* CreatePerishable() {
+        return new Perishable();
+    }
+    
     // stores a single file record for the current object
     std::fstream& Perishable::store(std::fstream& file, bool newLine) const {
-        Product::store(file, false);
-        file << ',' << date;
+        LatencyTimer timer(latency_store);
+        Record rec;
+        char line[max_record_length];
+        toRecord(*this, rec);
+        file.write(line, schema::format<'P'>(rec, line) - line);
         if(newLine) {
             file << std::endl;
         }
@@ -30,6 +46,8 @@ namespace AMA {
     // extracts data fields for a single file record from the fstream object
     std::fstream& Perishable::load(std::fstream& file) {
         
+        LatencyTimer timer(latency_load);
+        
         // if fail, sets failbit and sets object to safe empty state
         if (file.fail()) {
             file.setstate(std::ios::failbit);
@@ -49,6 +67,8 @@ namespace AMA {
     // if linear is false, function adds new line character followed by the string “Expiry date: "
     std::ostream& Perishable::write(std::ostream& os, bool linear) const {
         
+        LatencyTimer timer(latency_write);
+        
         if(message().length() > 0) {
             os << message();
         } else {
@@ -67,6 +87,8 @@ namespace AMA {
     // populates the current object with data extracted from istream
     std::istream& Perishable::read(std::istream& is) {
 
+        LatencyTimer timer(latency_read);
+        
         Product::read(is);
                 
         char discard[30];
@@ -111,5 +133,17 @@ namespace AMA {
     const Date& Perishable::expiry() const {
         return date;
     }
+    
+    // replaces expiry date
+    void Perishable::expiry(const Date& newDate) {
+        date = newDate;
+    }
+    
+    // adds the fields of Product and the expiry date
+    void Perishable::memoryUsage(MemoryUsage& usage) const {
+        Product::memoryUsage(usage);
+        usage.fields += sizeof(Perishable) - sizeof(Product) - sizeof(Date);
+        usage.dates += sizeof(Date);
+    }
 
 }
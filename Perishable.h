@@ -22,7 +22,9 @@ namespace AMA {
         std::ostream& write(std::ostream& os, bool linear) const;
         std::istream& read(std::istream& is);
         const Date& expiry() const;
+        void expiry(const Date&);
         void setEmpty();
+        void memoryUsage(MemoryUsage& usage) const;
         
     };
     
@@ -8,9 +8,73 @@
 #include <iomanip>
 #include <string>
 #include "Product.h"
+#include "Schema.h"
+#include "UnitTable.h"
+#include "ChangeStream.h"
+#include "Latency.h"
+#include "Memory.h"
 
 namespace AMA {
     
+    namespace {
+        
+        // depth of load() and read() calls on this thread, their setEmpty() calls are reported by ChangeScope
+        thread_local int replacing = 0;
+        
+        // publishes a change to the installed stream, if there is one
+        void publish(const char* sku, ChangeField field, double oldValue, double newValue) {
+            ChangeStream* stream = changeStream();
+            if(stream != nullptr) {
+                stream->publish(sku, field, oldValue, newValue);
+            }
+        }
+        
+        // remembers a product before load() or read() and publishes what changed when the call returns
+        class ChangeScope {
+            
+            const Product& prd_;
+            ChangeStream* stream_;
+            char sku_[max_sku_length + 1];
+            int qty_;
+            int qtyNeeded_;
+            double price_;
+            
+        public:
+            ChangeScope(const Product& prd) : prd_(prd), stream_(changeStream()) {
+                if(stream_ != nullptr) {
+                    replacing++;
+                    strncpy(sku_, prd.sku(), max_sku_length);
+                    sku_[max_sku_length] = '\0';
+                    qty_ = prd.quantity();
+                    qtyNeeded_ = prd.qtyNeeded();
+                    price_ = prd.price();
+                }
+            }
+            
+            ~ChangeScope() {
+                if(stream_ == nullptr) {
+                    return;
+                }
+                replacing--;
+                if(prd_.sku()[0] == '\0') {
+                    if(sku_[0] != '\0') {
+                        stream_->publish(sku_, change_cleared, qty_, 0);
+                    }
+                    return;
+                }
+                stream_->publish(prd_.sku(), change_loaded, qty_, prd_.quantity());
+                if(prd_.qtyNeeded() != qtyNeeded_) {
+                    stream_->publish(prd_.sku(), change_qtyNeeded, qtyNeeded_, prd_.qtyNeeded());
+                }
+                if(prd_.price() != price_) {
+                    stream_->publish(prd_.sku(), change_price, price_, prd_.price());
+                }
+            }
+            
+        };
+        
+    }
+    
     // stores name in dynamically allocated memory & replaces any name previously stored
     void Product::name(const char* nm) {
         
@@ -27,14 +91,15 @@ namespace AMA {
             
         } else {
             
-            // allocates memory for name_
-            name_ = new char [max_name_length + 1];
+            // allocates memory for name_, cut to max_name_length characters
+            size_t length = strnlen(nm, max_name_length);
+            name_ = new char [length + 1];
             
             // copies nm into name_
-            strncpy(name_, nm, max_name_length);
+            memcpy(name_, nm, length);
             
             // makes sure the string name terminates with null character
-            this->name_[max_name_length] = '\0';
+            this->name_[length] = '\0';
             
         }
     }
@@ -66,38 +131,59 @@ namespace AMA {
         return msg_;
     }
     
-    // sets object to safe empty state
+    // sets object to safe empty state and publishes the change
     void Product::setEmpty() {
+        if(replacing == 0 && sku_[0] != '\0') {
+            publish(sku_, change_cleared, qty, 0);
+        }
+        reset();
+    }
+    
+    // sets object to safe empty state without publishing, constructors call it on uninitialized members
+    void Product::reset() {
         
         // allocates memory for one character
         name_ = new char [1];
         
         sku_[0] = '\0';
-        unit_[0] = '\0';
+        unit_ = 0;
         name_[0] = '\0';
         qty = 0;
         qtyNeeded_ = 0;
         price_ = 0.0;
+        isTaxed = false;
     }
     
     // copies over type and sets object to safe empty state
     Product::Product(char type) {
         this->type_ = type;
-        setEmpty();
+        reset();
     }
     
     // initializes object and copies values to current object
-    void Product::init(const char* sku, const char* name_, const char* unit, int qty, bool isTaxed, double price, int qtyNeeded_) {
+    bool Product::init(const char* sku, const char* name_, const char* unit, int qty, bool isTaxed, double price, int qtyNeeded_) {
+        uint16_t id = units().intern(unit);
+        if(id == no_unit) {
+            reset();
+            message("Too many distinct units");
+            return false;
+        }
+        init(sku, name_, id, qty, isTaxed, price, qtyNeeded_);
+        return true;
+    }
+    
+    // initializes object with a unit already in the unit table, so copies do not take its lock
+    void Product::init(const char* sku, const char* name_, uint16_t unit, int qty, bool isTaxed, double price, int qtyNeeded_) {
         
-        this->name_ = new char [strlen(name_) + 1];
+        size_t length = strnlen(name_, max_name_length);
+        this->name_ = new char [length + 1];
         
         strncpy(this->sku_, sku, max_sku_length);
-        strncpy(this->name_, name_, max_name_length);
-        strncpy(this->unit_, unit, max_unit_length);
+        memcpy(this->name_, name_, length);
+        this->unit_ = unit;
         
         this->sku_[max_sku_length] = '\0';
-        this->name_[max_name_length] = '\0';
-        this->unit_[max_unit_length] = '\0';
+        this->name_[length] = '\0';
         
         
         this->qty = qty;
@@ -109,8 +195,10 @@ namespace AMA {
     // overloaded constructor that initializes the object and copies values to the current object
     Product::Product(const char* sku, const char* name_, const char* unit, int qty, bool isTaxed, double price, int qtyNeeded_) {
         
+        this->type_ = 'N';
+        
         if(sku == nullptr || name_ == nullptr || unit == nullptr || qty <0 || price < 0 || qtyNeeded_ < 0) {
-            setEmpty();
+            reset();
         } else {
             init(sku, name_, unit, qty, isTaxed, price, qtyNeeded_);
         }
@@ -119,6 +207,7 @@ namespace AMA {
     
     // copies object referenced to current object
     Product::Product(const Product& prd) {
+        type_ = prd.type_;
         init(prd.sku_, prd.name_, prd.unit_, prd.qty, prd.isTaxed, prd.price_, prd.qtyNeeded_);
     }
     
@@ -138,7 +227,11 @@ namespace AMA {
     
     // inserts into fstream object the character that identifies the product type and the data for current object
     std::fstream& Product::store(std::fstream& file, bool newLine) const {
-        file << type_ << ',' << sku_ << ',' << name_ << ',' << unit_ << ',' << taxed() << ',' << price_ << ',' << qty << ',' << qtyNeeded_;
+        LatencyTimer timer(latency_store);
+        Record rec;
+        char line[max_record_length];
+        toRecord(*this, rec);
+        file.write(line, schema::format<'N'>(rec, line) - line);
         if(newLine) {
             file << std::endl;
         }
@@ -148,6 +241,9 @@ namespace AMA {
     // extracts fields for a single record from fstream object
     std::fstream& Product::load(std::fstream& file) {
         
+        LatencyTimer timer(latency_load);
+        ChangeScope scope(*this);
+        
         // deallocates dynamic memory
         delete [] name_;
         
@@ -174,7 +270,9 @@ namespace AMA {
         }
         
         // gets unit_
-        file.getline(unit_, max_unit_length, ',');
+        char unit[max_unit_length + 1];
+        
+        file.getline(unit, max_unit_length, ',');
         
         if (file.fail()) {
             file.setstate(std::ios::failbit);
@@ -182,6 +280,15 @@ namespace AMA {
             return file;
         }
         
+        unit_ = units().intern(unit);
+        
+        if (unit_ == no_unit) {
+            message("Too many distinct units");
+            file.setstate(std::ios::failbit);
+            setEmpty();
+            return file;
+        }
+        
         int isTaxedInt;
         
         // inserts taxable
@@ -247,6 +354,8 @@ namespace AMA {
     // inserts data fields for current object into ostream object separated by '|'
     std::ostream& Product::write(std::ostream& os, bool linear) const {
         
+        LatencyTimer timer(latency_write);
+        
         if(message().length() > 0) {
             os << message();
             return os;
@@ -276,7 +385,7 @@ namespace AMA {
             
             // inserts unit_ into ostream object
             os.width(10);
-            os << std::left << unit_ << '|';
+            os << std::left << unit() << '|';
             os << std::right;
             
             // inserts qytNeeded_ into ostream object
@@ -293,7 +402,7 @@ namespace AMA {
             } else {
                 os << " Price after tax: N/A" << std::endl;
             }
-            os << " Quantity on Hand: " << qty << " " << unit_ << std::endl;
+            os << " Quantity on Hand: " << qty << " " << unit() << std::endl;
             os << " Quantity needed: " << qtyNeeded_;
         }
         
@@ -303,6 +412,9 @@ namespace AMA {
     // extracts data field for current object
     std::istream& Product::read(std::istream& is) {
         
+        LatencyTimer timer(latency_read);
+        ChangeScope scope(*this);
+        
         // clears out error
         message("");
         
@@ -439,14 +551,16 @@ namespace AMA {
         
         delete [] this->name_;
         
-        init(sku, name_.c_str(), unit, qty, isTaxed, price, qtyNeeded_);
+        if (!init(sku, name_.c_str(), unit, qty, isTaxed, price, qtyNeeded_)) {
+            is.setstate(std::ios::failbit);
+        }
         
         return is;
     }
     
     // returns if string is identical to sku of current object
     bool Product::operator==(const char* str) const {
-        return this->sku_ == str;
+        return str != nullptr && strcmp(this->sku_, str) == 0;
     }
     
     // returns total cost of all items on hand including taxes
@@ -456,14 +570,18 @@ namespace AMA {
     
     // resets number of units on hand to number received
     void Product::quantity(int unit) {
+        int old = this->qty;
         this->qty = unit;
+        if(old != unit) {
+            publish(sku_, change_quantity, old, unit);
+        }
     }
     
     // returns true if object is in a safe empty state
     bool Product::isEmpty() const {
         return  type_ == '\0' &&
         sku_[0] == '\0' &&
-        unit_[0] == '\0' &&
+        unit_ == 0 &&
         name_ == nullptr &&
         qty == 0 &&
         qtyNeeded_ == 0 &&
@@ -495,10 +613,16 @@ namespace AMA {
     int Product::operator+=(int qty) {
         if(qty > 0) {
             this->qty += qty;
+            publish(sku_, change_quantity, this->qty - qty, this->qty);
         }
         return this->qty;
     }
     
+    // returns the address of a new Product object
+    iProduct* CreateProduct() {
+        return new Product();
+    }
+    
     // returns reference to ostream object
     std::ostream& operator<<(std::ostream& ostr, const iProduct& src) {
         return src.write(ostr, true);
@@ -511,9 +635,11 @@ namespace AMA {
         
     }
     
-    // returns the sum of total cost and price received
-    double operator+=(double& price, const Product& src) {
-        return price + src.total_cost();
+    // adds the total cost of the referenced product to price received
+    // returns the updated value of price
+    double operator+=(double& price, const iProduct& src) {
+        price += src.total_cost();
+        return price;
     }
     
     // returns sku_
@@ -522,8 +648,13 @@ namespace AMA {
         
     }
     
-    // returns unit_
+    // returns the text of unit_ from the unit table
     const char* Product::unit() const {
+        return units().name(unit_);
+    }
+    
+    // returns unit_, the id of the unit in the unit table
+    uint16_t Product::unitId() const {
         return unit_;
     }
     
@@ -546,6 +677,25 @@ namespace AMA {
     void Product::type(char newType) {
         this->type_ = newType;
     }
+    
+    // adds the object, its heap name and any message too long for the string to hold inline
+    void Product::memoryUsage(MemoryUsage& usage) const {
+        const char* text = msg_.data();
+        bool inlineText = text >= reinterpret_cast<const char*>(&msg_) && text < reinterpret_cast<const char*>(&msg_ + 1);
+        usage.count++;
+        usage.vtables += sizeof(void*);
+        usage.fields += sizeof(Product) - sizeof(void*) - sizeof(std::string);
+        usage.messages += sizeof(std::string);
+        if(!inlineText) {
+            usage.messages += msg_.capacity() + 1;
+            usage.blocks++;
+        }
+        // every path allocates name_ to fit the name it holds
+        if(name_ != nullptr) {
+            usage.names += strlen(name_) + 1;
+            usage.blocks++;
+        }
+    }
 
 }
 
@@ -5,11 +5,15 @@
 #ifndef Product_hpp
 #define Product_hpp
 
+#include <stdint.h>
 #include <iostream>
 #include "iProduct.h"
 
 namespace AMA {
     
+    struct MemoryUsage;
+    struct Record;
+    
     const int max_sku_length = 7;
     const int max_name_length = 10;
     const int max_unit_length = 75;
@@ -20,7 +24,7 @@ namespace AMA {
         // instance variables
         char type_;
         char sku_[max_sku_length + 1];
-        char unit_[max_unit_length + 1];
+        uint16_t unit_;                         // id in the unit table
         char* name_;
         int qty;
         int qtyNeeded_;
@@ -29,6 +33,12 @@ namespace AMA {
         bool isTaxed;
         std::string msg_;
         
+        void reset();
+        
+        // restores every field from a record without the checks of the public constructor, as load() does
+        friend bool fromRecord(const Record& rec, iProduct& prd);
+        void init(const char* sku, const char* name_, uint16_t unit, int qty, bool isTaxed, double price, int qtyNeeded_);
+        
     protected:
         void name(const char*);
         const char* name() const;
@@ -40,7 +50,9 @@ namespace AMA {
         
     public:
         void setEmpty();
-        void init(const char* sku, const char* name_, const char* unit, int qty, bool isTaxed, double price, int qtyNeeded_);
+        
+        // returns false and leaves the object empty with a message if the unit table is full
+        bool init(const char* sku, const char* name_, const char* unit, int qty, bool isTaxed, double price, int qtyNeeded_);
         
         // zero-one argument constructor
         Product(char type = 'N');
@@ -67,6 +79,7 @@ namespace AMA {
         
         const char* sku() const;
         const char* unit() const;
+        uint16_t unitId() const;
         bool taxed() const;
         double price() const;
         
@@ -75,6 +88,9 @@ namespace AMA {
         
         bool operator>(const iProduct&) const;
         
+        // adds the bytes held by this product to usage
+        virtual void memoryUsage(MemoryUsage& usage) const;
+        
     };
     
     // helper functions
@@ -0,0 +1,180 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the SlabPool, PooledProduct and ProductPool classes. Objects are still constructed and destroyed normally, only the memory they live in is recycled, so pooled products behave exactly like products from CreateProduct().
+ ----------------------------------------------- */
+
+#include <cstddef>
+#include <new>
+#include "Perishable.h"
+#include "ProductPool.h"
+
+namespace AMA {
+    
+    // blocks are rounded up to hold a pointer and keep the alignment of the objects they hold
+    SlabPool::SlabPool(size_t blockSize, size_t blocksPerSlab) {
+        const size_t align = alignof(std::max_align_t);
+        blockSize_ = blockSize < sizeof(void*) ? sizeof(void*) : blockSize;
+        blockSize_ = (blockSize_ + align - 1) / align * align;
+        blocksPerSlab_ = blocksPerSlab > 0 ? blocksPerSlab : 1;
+        free_ = nullptr;
+        used_ = blocksPerSlab_;
+        live_ = 0;
+    }
+    
+    // frees every slab
+    SlabPool::~SlabPool() {
+        for(size_t i = 0; i < slabs_.size(); i++) {
+            delete [] slabs_[i];
+        }
+    }
+    
+    // returns an uninitialized block, reusing a released one if there is any
+    void* SlabPool::allocate() {
+        
+        live_++;
+        
+        if(free_ != nullptr) {
+            void* block = free_;
+            free_ = *static_cast<void**>(block);
+            return block;
+        }
+        
+        if(used_ == blocksPerSlab_) {
+            slabs_.push_back(new char [blockSize_ * blocksPerSlab_]);
+            used_ = 0;
+        }
+        
+        return slabs_.back() + blockSize_ * used_++;
+    }
+    
+    // puts block on the free list
+    void SlabPool::deallocate(void* block) {
+        *static_cast<void**>(block) = free_;
+        free_ = block;
+        live_--;
+    }
+    
+    // returns the number of blocks handed out and not yet released
+    size_t SlabPool::live() const {
+        return live_;
+    }
+    
+    // returns the number of blocks in all slabs
+    size_t SlabPool::capacity() const {
+        return slabs_.size() * blocksPerSlab_;
+    }
+    
+    // returns the number of bytes allocated for slabs
+    size_t SlabPool::memoryUsage() const {
+        return slabs_.size() * blocksPerSlab_ * blockSize_ + slabs_.capacity() * sizeof(char*);
+    }
+    
+    // sets handle to safe empty state
+    PooledProduct::PooledProduct() {
+        pool_ = nullptr;
+        product_ = nullptr;
+    }
+    
+    // takes ownership of product from pool
+    PooledProduct::PooledProduct(ProductPool* pool, iProduct* product) {
+        pool_ = pool;
+        product_ = product;
+    }
+    
+    // takes ownership from src, leaving it empty
+    PooledProduct::PooledProduct(PooledProduct&& src) {
+        pool_ = src.pool_;
+        product_ = src.product_;
+        src.pool_ = nullptr;
+        src.product_ = nullptr;
+    }
+    
+    // gives back the current product and takes ownership from src
+    PooledProduct& PooledProduct::operator=(PooledProduct&& src) {
+        if(this != &src) {
+            reset();
+            pool_ = src.pool_;
+            product_ = src.product_;
+            src.pool_ = nullptr;
+            src.product_ = nullptr;
+        }
+        return *this;
+    }
+    
+    // gives the product back to its pool
+    PooledProduct::~PooledProduct() {
+        reset();
+    }
+    
+    // returns the owned product
+    iProduct* PooledProduct::get() const {
+        return product_;
+    }
+    
+    iProduct& PooledProduct::operator*() const {
+        return *product_;
+    }
+    
+    iProduct* PooledProduct::operator->() const {
+        return product_;
+    }
+    
+    // returns true if the handle owns a product
+    PooledProduct::operator bool() const {
+        return product_ != nullptr;
+    }
+    
+    // gives the product back to its pool and returns to safe empty state
+    void PooledProduct::reset() {
+        if(product_ != nullptr) {
+            pool_->destroy(product_);
+        }
+        pool_ = nullptr;
+        product_ = nullptr;
+    }
+    
+    // creates empty pools, slabs are allocated on first use
+    ProductPool::ProductPool(size_t blocksPerSlab) : products_(sizeof(Product), blocksPerSlab), perishables_(sizeof(Perishable), blocksPerSlab) {
+        
+    }
+    
+    // returns a handle to a new Product object
+    PooledProduct ProductPool::createProduct() {
+        return PooledProduct(this, new (products_.allocate()) Product());
+    }
+    
+    // returns a handle to a new Perishable object
+    PooledProduct ProductPool::createPerishable() {
+        return PooledProduct(this, new (perishables_.allocate()) Perishable());
+    }
+    
+    // returns a handle to a new Perishable for type 'P', a new Product otherwise
+    PooledProduct ProductPool::create(char type) {
+        return type == 'P' ? createPerishable() : createProduct();
+    }
+    
+    // destroys a product created by this pool and recycles its memory
+    void ProductPool::destroy(iProduct* product) {
+        
+        Perishable* per = dynamic_cast<Perishable*>(product);
+        
+        if(per != nullptr) {
+            per->~Perishable();
+            perishables_.deallocate(per);
+        } else {
+            Product* prd = static_cast<Product*>(product);
+            prd->~Product();
+            products_.deallocate(prd);
+        }
+    }
+    
+    // returns the number of products handed out and not yet given back
+    size_t ProductPool::live() const {
+        return products_.live() + perishables_.live();
+    }
+    
+    // returns the number of bytes allocated for slabs
+    size_t ProductPool::memoryUsage() const {
+        return products_.memoryUsage() + perishables_.memoryUsage();
+    }
+    
+}
@@ -0,0 +1,87 @@
+/* --------------------------------------------
+ Description: This is the header file for ProductPool.cpp. It declares the SlabPool class, which hands out fixed size blocks carved from large slabs and keeps released blocks on a free list, and the ProductPool class, a pooled replacement for CreateProduct() and CreatePerishable() that returns owning handles.
+ ----------------------------------------------- */
+
+#ifndef AMA_PRODUCTPOOL_H_
+#define AMA_PRODUCTPOOL_H_
+
+#include <stddef.h>
+#include <vector>
+#include "iProduct.h"
+
+namespace AMA {
+    
+    class SlabPool {
+        
+        size_t blockSize_;
+        size_t blocksPerSlab_;
+        std::vector<char*> slabs_;
+        void* free_;                            // first free block, each free block holds the next
+        size_t used_;                           // blocks handed out of the newest slab
+        size_t live_;
+        
+    public:
+        SlabPool(size_t blockSize, size_t blocksPerSlab = 1024);
+        SlabPool(const SlabPool&) = delete;
+        SlabPool& operator=(const SlabPool&) = delete;
+        ~SlabPool();
+        
+        void* allocate();
+        void deallocate(void* block);
+        
+        size_t live() const;
+        size_t capacity() const;
+        size_t memoryUsage() const;
+        
+    };
+    
+    class ProductPool;
+    
+    // owns one product from a ProductPool and gives it back when destroyed
+    class PooledProduct {
+        
+        ProductPool* pool_;
+        iProduct* product_;
+        
+    public:
+        PooledProduct();
+        PooledProduct(ProductPool* pool, iProduct* product);
+        PooledProduct(PooledProduct&& src);
+        PooledProduct& operator=(PooledProduct&& src);
+        PooledProduct(const PooledProduct&) = delete;
+        PooledProduct& operator=(const PooledProduct&) = delete;
+        ~PooledProduct();
+        
+        iProduct* get() const;
+        iProduct& operator*() const;
+        iProduct* operator->() const;
+        explicit operator bool() const;
+        
+        void reset();
+        
+    };
+    
+    // allocates Product and Perishable objects from slabs, one pool per thread
+    // every product must be given back before the pool is destroyed
+    class ProductPool {
+        
+        SlabPool products_;
+        SlabPool perishables_;
+        
+    public:
+        ProductPool(size_t blocksPerSlab = 1024);
+        
+        PooledProduct createProduct();
+        PooledProduct createPerishable();
+        PooledProduct create(char type);
+        
+        void destroy(iProduct* product);
+        
+        size_t live() const;
+        size_t memoryUsage() const;
+        
+    };
+    
+}
+
+#endif
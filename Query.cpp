@@ -0,0 +1,353 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the Query class. A raw line is split one field at a time and predicates are tested in field order, so a record is rejected as soon as one field fails and later fields are never converted.
+ ----------------------------------------------- */
+
+#include <float.h>
+#include <limits.h>
+#include <string.h>
+#include "RecordReader.h"
+#include "Query.h"
+
+namespace AMA {
+    
+    // sets query to match every record and select every column
+    Query::Query() {
+        tested_ = 0;
+        columns_ = col_all;
+        type_ = '\0';
+        taxed_ = false;
+        minPrice_ = -DBL_MAX;
+        maxPrice_ = DBL_MAX;
+        minQty_ = INT_MIN;
+        maxQty_ = INT_MAX;
+        minQtyNeeded_ = INT_MIN;
+        maxQtyNeeded_ = INT_MAX;
+        minExpiry_ = INT_MIN;
+        maxExpiry_ = INT_MAX;
+        shortfall_ = false;
+    }
+    
+    // matches records of type 'N' or 'P'
+    Query& Query::type(char type) {
+        type_ = type;
+        tested_ |= col_type;
+        return *this;
+    }
+    
+    // matches records whose sku starts with prefix
+    Query& Query::skuPrefix(const char* prefix) {
+        skuPrefix_ = prefix;
+        tested_ |= col_sku;
+        return *this;
+    }
+    
+    // matches records with exactly this name
+    Query& Query::name(const char* name) {
+        name_ = name;
+        tested_ |= col_name;
+        return *this;
+    }
+    
+    // matches records with exactly this unit
+    Query& Query::unit(const char* unit) {
+        unit_ = unit;
+        tested_ |= col_unit;
+        return *this;
+    }
+    
+    // matches records that are taxed, or not taxed
+    Query& Query::taxed(bool taxed) {
+        taxed_ = taxed;
+        tested_ |= col_taxed;
+        return *this;
+    }
+    
+    // matches records with price in [min, max]
+    Query& Query::price(double min, double max) {
+        minPrice_ = min;
+        maxPrice_ = max;
+        tested_ |= col_price;
+        return *this;
+    }
+    
+    // matches records with quantity on hand in [min, max]
+    Query& Query::quantity(int min, int max) {
+        minQty_ = min;
+        maxQty_ = max;
+        tested_ |= col_qty;
+        return *this;
+    }
+    
+    // matches records with quantity needed in [min, max]
+    Query& Query::qtyNeeded(int min, int max) {
+        minQtyNeeded_ = min;
+        maxQtyNeeded_ = max;
+        tested_ |= col_qtyNeeded;
+        return *this;
+    }
+    
+    // matches perishable records expiring in [from, to]
+    Query& Query::expiry(const Date& from, const Date& to) {
+        minExpiry_ = from.dayNumber() != 0 ? from.dayNumber() : INT_MIN;
+        maxExpiry_ = to.dayNumber() != 0 ? to.dayNumber() : INT_MAX;
+        tested_ |= col_expiry;
+        return *this;
+    }
+    
+    // matches records with fewer units on hand than needed
+    Query& Query::shortfall() {
+        shortfall_ = true;
+        tested_ |= col_qty | col_qtyNeeded;
+        return *this;
+    }
+    
+    // selects the columns copied into matching records
+    Query& Query::select(unsigned columns) {
+        columns_ = columns & col_all;
+        return *this;
+    }
+    
+    // returns the selected columns
+    unsigned Query::columns() const {
+        return columns_;
+    }
+    
+    // tests the predicate on a single column of rec, true if the column has no predicate
+    bool Query::test(unsigned column, const Record& rec) const {
+        switch(column & tested_) {
+            case col_type:
+                return rec.type == type_;
+            case col_sku:
+                return strncmp(rec.sku, skuPrefix_.c_str(), skuPrefix_.size()) == 0;
+            case col_name:
+                return name_ == rec.name;
+            case col_unit:
+                return unit_ == rec.unit;
+            case col_taxed:
+                return rec.taxed == taxed_;
+            case col_price:
+                return rec.price >= minPrice_ && rec.price <= maxPrice_;
+            case col_qty:
+                return rec.qty >= minQty_ && rec.qty <= maxQty_;
+            case col_qtyNeeded:
+                // qtyNeeded is the later of the two shortfall fields, so both are known here
+                return rec.qtyNeeded >= minQtyNeeded_ && rec.qtyNeeded <= maxQtyNeeded_ &&
+                (!shortfall_ || rec.qty < rec.qtyNeeded);
+            case col_expiry:
+                return rec.expiry != 0 && rec.expiry >= minExpiry_ && rec.expiry <= maxExpiry_;
+            default:
+                return true;
+        }
+    }
+    
+    // returns true if rec passes every predicate
+    bool Query::matches(const Record& rec) const {
+        for(unsigned column = 1; column < col_all; column <<= 1) {
+            if(!test(column, rec)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // clears the fields of rec that are not in columns
+    static void project(Record& rec, unsigned columns) {
+        if((columns & col_type) == 0) {
+            rec.type = '\0';
+        }
+        if((columns & col_sku) == 0) {
+            rec.sku[0] = '\0';
+        }
+        if((columns & col_name) == 0) {
+            rec.name[0] = '\0';
+        }
+        if((columns & col_unit) == 0) {
+            rec.unit[0] = '\0';
+        }
+        if((columns & col_taxed) == 0) {
+            rec.taxed = false;
+        }
+        if((columns & col_price) == 0) {
+            rec.price = 0.0;
+        }
+        if((columns & col_qty) == 0) {
+            rec.qty = 0;
+        }
+        if((columns & col_qtyNeeded) == 0) {
+            rec.qtyNeeded = 0;
+        }
+        if((columns & col_expiry) == 0) {
+            rec.expiry = 0;
+        }
+    }
+    
+    // copies field [begin, end) into buf of size characters, false if it does not fit
+    static bool copyText(const char* begin, const char* end, char* buf, size_t size) {
+        if((size_t)(end - begin) >= size) {
+            return false;
+        }
+        memcpy(buf, begin, end - begin);
+        buf[end - begin] = '\0';
+        return true;
+    }
+    
+    // tests a line written by store() without converting fields that are not needed
+    // on a match, rec holds the selected columns
+    bool Query::matches(const char* line, size_t length, Record& rec) const {
+        
+        const char* end = line + length;
+        const char* field = line;
+        unsigned needed = tested_ | columns_;
+        
+        if(end > line && end[-1] == '\r') {
+            end--;
+        }
+        
+        clear(rec);
+        
+        // stops after the last field that is tested or selected
+        for(unsigned column = 1; column < col_all && (needed & ~(column - 1)) != 0; column <<= 1) {
+            
+            if(field > end) {
+                // a Product record has no expiry field
+                if(column == col_expiry && (tested_ & col_expiry) == 0) {
+                    break;
+                }
+                return false;
+            }
+            
+            const char* stop = static_cast<const char*>(memchr(field, ',', end - field));
+            if(stop == nullptr) {
+                stop = end;
+            }
+            
+            if(needed & column) {
+                bool ok = false;
+                switch(column) {
+                    case col_type:
+                        ok = stop - field == 1;
+                        rec.type = *field;
+                        break;
+                    case col_sku:
+                        ok = copyText(field, stop, rec.sku, sizeof(rec.sku));
+                        break;
+                    case col_name:
+                        ok = copyText(field, stop, rec.name, sizeof(rec.name));
+                        break;
+                    case col_unit:
+                        ok = copyText(field, stop, rec.unit, sizeof(rec.unit));
+                        break;
+                    case col_taxed:
+                        ok = stop - field == 1 && (*field == '0' || *field == '1');
+                        rec.taxed = *field == '1';
+                        break;
+                    case col_price:
+                        ok = parseDouble(field, stop, rec.price);
+                        break;
+                    case col_qty:
+                        ok = parseInt(field, stop, rec.qty);
+                        break;
+                    case col_qtyNeeded:
+                        ok = parseInt(field, stop, rec.qtyNeeded);
+                        break;
+                    case col_expiry:
+                        ok = parseDate(field, stop, rec.expiry);
+                        break;
+                }
+                if(!ok || !test(column, rec)) {
+                    return false;
+                }
+            }
+            
+            field = stop + 1;
+        }
+        
+        project(rec, columns_);
+        
+        return true;
+    }
+    
+    // returns false only if no record summarized by stats can match
+    bool Query::mayMatch(const BlockStats& stats) const {
+        
+        if((tested_ & col_price) && (stats.maxPrice < minPrice_ || stats.minPrice > maxPrice_)) {
+            return false;
+        }
+        if((tested_ & col_qty) && (stats.maxQty < minQty_ || stats.minQty > maxQty_)) {
+            return false;
+        }
+        if((tested_ & col_qtyNeeded) && (stats.maxQtyNeeded < minQtyNeeded_ || stats.minQtyNeeded > maxQtyNeeded_)) {
+            return false;
+        }
+        if(shortfall_ && stats.minQty >= stats.maxQtyNeeded) {
+            return false;
+        }
+        if((tested_ & col_expiry) && (stats.perishables == 0 || stats.maxExpiry < minExpiry_ || stats.minExpiry > maxExpiry_)) {
+            return false;
+        }
+        if((tested_ & col_type) && type_ == 'P' && stats.perishables == 0) {
+            return false;
+        }
+        if((tested_ & col_taxed) && taxed_ && stats.taxed == 0) {
+            return false;
+        }
+        if(tested_ & col_sku) {
+            // every sku with the prefix lies in [prefix, prefix followed by the largest characters]
+            // strcmp compares bytes as unsigned char, so the largest character is 0xff
+            std::string hi = skuPrefix_ + std::string(max_sku_length, '\xff');
+            if(strcmp(stats.maxSku, skuPrefix_.c_str()) < 0 || strcmp(stats.minSku, hi.c_str()) > 0) {
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    // scans a file written by store() and passes every matching record to visit
+    long long Query::run(const char* storePath, const std::function<bool(const Record&)>& visit) const {
+        
+        RecordReader reader;
+        const char* line;
+        size_t length;
+        Record rec;
+        long long count = 0;
+        
+        if(!reader.open(storePath)) {
+            return -1;
+        }
+        
+        while(reader.nextLine(line, length)) {
+            if(matches(line, length, rec)) {
+                count++;
+                if(!visit(rec)) {
+                    break;
+                }
+            }
+        }
+        
+        return count;
+    }
+    
+    // scans an archive, skipping blocks whose statistics rule out a match
+    // only the tested and selected columns are decoded
+    long long Query::run(const ArchiveReader& archive, const std::function<bool(const Record&)>& visit) const {
+        
+        long long count = 0;
+        Record out;
+        
+        bool ok = archive.scan(tested_ | columns_, [&](const BlockStats& stats) {
+            return mayMatch(stats);
+        }, [&](const Record& rec) {
+            if(!matches(rec)) {
+                return true;
+            }
+            count++;
+            out = rec;
+            project(out, columns_);
+            return visit(out);
+        });
+        
+        return ok ? count : -1;
+    }
+    
+}
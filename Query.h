@@ -0,0 +1,70 @@
+/* --------------------------------------------
+ Description: This is the header file for Query.cpp. It declares the Query class which filters product records by field while they are scanned from a store() file or an archive, parsing only the fields needed to decide and to fill the selected columns.
+ ----------------------------------------------- */
+
+#ifndef AMA_QUERY_H_
+#define AMA_QUERY_H_
+
+#include <functional>
+#include <string>
+#include "Archive.h"
+#include "Date.h"
+#include "Record.h"
+
+namespace AMA {
+    
+    class Query {
+        
+        unsigned tested_;                       // ArchiveColumn flags of fields with a predicate
+        unsigned columns_;                      // ArchiveColumn flags of fields copied to the result
+        char type_;
+        std::string skuPrefix_;
+        std::string name_;
+        std::string unit_;
+        bool taxed_;
+        double minPrice_;
+        double maxPrice_;
+        int minQty_;
+        int maxQty_;
+        int minQtyNeeded_;
+        int maxQtyNeeded_;
+        int minExpiry_;
+        int maxExpiry_;
+        bool shortfall_;
+        
+        bool test(unsigned column, const Record& rec) const;
+        
+    public:
+        Query();
+        
+        // predicates, all of them must hold for a record to match
+        // ranges are inclusive, a Date in safe empty state leaves that end of the range open
+        Query& type(char type);
+        Query& skuPrefix(const char* prefix);
+        Query& name(const char* name);
+        Query& unit(const char* unit);
+        Query& taxed(bool taxed);
+        Query& price(double min, double max);
+        Query& quantity(int min, int max);
+        Query& qtyNeeded(int min, int max);
+        Query& expiry(const Date& from, const Date& to);
+        Query& shortfall();
+        
+        // fields copied into matching records, other fields are left empty
+        Query& select(unsigned columns);
+        unsigned columns() const;
+        
+        bool matches(const Record& rec) const;
+        bool matches(const char* line, size_t length, Record& rec) const;
+        bool mayMatch(const BlockStats& stats) const;
+        
+        // passes every matching record to visit, which returns false to stop
+        // returns the number of matching records, -1 if the source cannot be read
+        long long run(const char* storePath, const std::function<bool(const Record&)>& visit) const;
+        long long run(const ArchiveReader& archive, const std::function<bool(const Record&)>& visit) const;
+        
+    };
+    
+}
+
+#endif
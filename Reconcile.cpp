@@ -0,0 +1,406 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the Reconciler class and the functions that compare and format record differences. When the older file fits the memory budget it is compared straight from the text files, otherwise both files are first split into the same hash partitions of binary records in anonymous temporary files.
+ ----------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "Date.h"
+#include "RecordReader.h"
+#include "SkuIndex.h"
+#include "Reconcile.h"
+
+namespace AMA {
+    
+    namespace {
+        
+        // shortest line store() writes, used to bound the records a file can hold
+        const long long min_line_length = 20;
+        
+        // bytes held per record of the older file: the record, its hash table slots and its seen flag
+        const size_t record_memory = sizeof(Record) + 32;
+        
+        // returns the size of the file at path, -1 if it cannot be opened
+        long long fileSize(const char* path) {
+            FILE* file = fopen(path, "rb");
+            if(file == nullptr) {
+                return -1;
+            }
+            fseek(file, 0, SEEK_END);
+            long long size = ftell(file);
+            fclose(file);
+            return size;
+        }
+        
+        // returns the partition of key, using the high bits so it is independent of the hash table
+        int partitionOf(uint64_t key, int count) {
+            return (int)(((key * 0x9E3779B97F4A7C15ULL) >> 32) % (uint64_t)count);
+        }
+        
+        // open addressing table from packed sku to the position of its record, no allocation per entry
+        class SkuTable {
+            
+            std::vector<uint64_t> keys_;
+            std::vector<uint32_t> slots_;       // position + 1, 0 for a free slot
+            size_t mask_;
+            size_t size_;
+            
+            size_t home(uint64_t key) const {
+                return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 20) & mask_;
+            }
+            
+            void grow() {
+                std::vector<uint64_t> keys(keys_.size() * 2);
+                std::vector<uint32_t> slots(slots_.size() * 2, 0);
+                keys_.swap(keys);
+                slots_.swap(slots);
+                mask_ = keys_.size() - 1;
+                for(size_t i = 0; i < keys.size(); i++) {
+                    if(slots[i] != 0) {
+                        size_t j = home(keys[i]);
+                        while(slots_[j] != 0) {
+                            j = (j + 1) & mask_;
+                        }
+                        keys_[j] = keys[i];
+                        slots_[j] = slots[i];
+                    }
+                }
+            }
+            
+        public:
+            SkuTable() : keys_(1024), slots_(1024, 0), mask_(1023), size_(0) {
+                
+            }
+            
+            // returns the position stored for key, or stores position and returns it if key is new
+            uint32_t insert(uint64_t key, uint32_t position) {
+                if(2 * (size_ + 1) > keys_.size()) {
+                    grow();
+                }
+                size_t i = home(key);
+                while(slots_[i] != 0) {
+                    if(keys_[i] == key) {
+                        return slots_[i] - 1;
+                    }
+                    i = (i + 1) & mask_;
+                }
+                keys_[i] = key;
+                slots_[i] = position + 1;
+                size_++;
+                return position;
+            }
+            
+            // returns the position stored for key, -1 if there is none
+            long long find(uint64_t key) const {
+                size_t i = home(key);
+                while(slots_[i] != 0) {
+                    if(keys_[i] == key) {
+                        return slots_[i] - 1;
+                    }
+                    i = (i + 1) & mask_;
+                }
+                return -1;
+            }
+            
+        };
+        
+        // writes day number days as YYYY/MM/DD, nothing for 0
+        int formatDay(int days, char* buf) {
+            if(days == 0) {
+                buf[0] = '\0';
+                return 0;
+            }
+            int year, month, day;
+            civilFromDays(days, year, month, day);
+            return sprintf(buf, "%04d/%02d/%02d", year, month, day);
+        }
+        
+    }
+    
+    // returns the DiffField bits that differ between before and after
+    unsigned compareRecords(const Record& before, const Record& after) {
+        unsigned fields = 0;
+        if(before.type != after.type) {
+            fields |= diff_type;
+        }
+        if(strcmp(before.name, after.name) != 0) {
+            fields |= diff_name;
+        }
+        if(strcmp(before.unit, after.unit) != 0) {
+            fields |= diff_unit;
+        }
+        if(before.taxed != after.taxed) {
+            fields |= diff_taxed;
+        }
+        if(before.price != after.price) {
+            fields |= diff_price;
+        }
+        if(before.qty != after.qty) {
+            fields |= diff_qty;
+        }
+        if(before.qtyNeeded != after.qtyNeeded) {
+            fields |= diff_qtyNeeded;
+        }
+        if(before.expiry != after.expiry) {
+            fields |= diff_expiry;
+        }
+        return fields;
+    }
+    
+    // writes diff as one line into buf and returns the number of characters written
+    int formatDifference(const Difference& diff, char* buf) {
+        
+        buf[0] = (char)diff.kind;
+        buf[1] = ',';
+        
+        if(diff.kind == diff_added) {
+            return 2 + formatRecord(*diff.after, buf + 2);
+        }
+        if(diff.kind == diff_removed) {
+            return 2 + formatRecord(*diff.before, buf + 2);
+        }
+        
+        const Record& a = *diff.before;
+        const Record& b = *diff.after;
+        char* p = buf + 2;
+        p += sprintf(p, "%s", b.sku);
+        
+        if(diff.fields & diff_type) {
+            p += sprintf(p, ",type=%c>%c", a.type, b.type);
+        }
+        if(diff.fields & diff_name) {
+            p += sprintf(p, ",name=%s>%s", a.name, b.name);
+        }
+        if(diff.fields & diff_unit) {
+            p += sprintf(p, ",unit=%s>%s", a.unit, b.unit);
+        }
+        if(diff.fields & diff_taxed) {
+            p += sprintf(p, ",taxed=%d>%d", a.taxed ? 1 : 0, b.taxed ? 1 : 0);
+        }
+        if(diff.fields & diff_price) {
+            p += sprintf(p, ",price=%g>%g", a.price, b.price);
+        }
+        if(diff.fields & diff_qty) {
+            p += sprintf(p, ",qty=%d>%d", a.qty, b.qty);
+        }
+        if(diff.fields & diff_qtyNeeded) {
+            p += sprintf(p, ",qtyNeeded=%d>%d", a.qtyNeeded, b.qtyNeeded);
+        }
+        if(diff.fields & diff_expiry) {
+            p += sprintf(p, ",expiry=");
+            p += formatDay(a.expiry, p);
+            *p++ = '>';
+            p += formatDay(b.expiry, p);
+        }
+        
+        *p++ = '\n';
+        *p = '\0';
+        return (int)(p - buf);
+    }
+    
+    Reconciler::Reconciler(size_t memory) : memory_(memory) {
+        memset(&stats_, 0, sizeof(stats_));
+    }
+    
+    // streams the records of path into the partition files by sku
+    bool Reconciler::partition(const char* path, FILE** parts, int count) {
+        
+        RecordReader reader;
+        if(!reader.open(path)) {
+            error_.message("Unable to open inventory file");
+            return false;
+        }
+        
+        Record rec;
+        while(reader.next(rec)) {
+            FILE* part = parts[partitionOf(SkuIndex::pack(rec.sku), count)];
+            if(fwrite(&rec, sizeof(Record), 1, part) != 1) {
+                error_.message("Unable to write reconcile partition");
+                return false;
+            }
+        }
+        stats_.errors += reader.errors();
+        
+        for(int i = 0; i < count; i++) {
+            if(fflush(parts[i]) != 0) {
+                error_.message("Unable to write reconcile partition");
+                return false;
+            }
+            rewind(parts[i]);
+        }
+        return true;
+    }
+    
+    // holds every record from before in a hash table, then streams after through it
+    bool Reconciler::compare(const std::function<bool(Record&)>& before, const std::function<bool(Record&)>& after,
+                             const std::function<bool(const Difference&)>& visit) {
+        
+        std::vector<Record> old;
+        SkuTable index;
+        Record rec;
+        
+        while(before(rec)) {
+            uint32_t position = index.insert(SkuIndex::pack(rec.sku), (uint32_t)old.size());
+            if(position == old.size()) {
+                old.push_back(rec);
+            } else {
+                old[position] = rec;
+            }
+        }
+        
+        std::vector<char> seen(old.size(), 0);
+        Difference diff;
+        
+        while(after(rec)) {
+            long long found = index.find(SkuIndex::pack(rec.sku));
+            if(found < 0) {
+                diff.kind = diff_added;
+                diff.fields = 0;
+                diff.before = nullptr;
+                diff.after = &rec;
+                stats_.added++;
+                if(!visit(diff)) {
+                    return false;
+                }
+                continue;
+            }
+            
+            const Record& prev = old[found];
+            seen[found] = 1;
+            diff.fields = compareRecords(prev, rec);
+            if(diff.fields == 0) {
+                stats_.unchanged++;
+                continue;
+            }
+            diff.kind = diff_changed;
+            diff.before = &prev;
+            diff.after = &rec;
+            stats_.changed++;
+            if(!visit(diff)) {
+                return false;
+            }
+        }
+        
+        for(size_t i = 0; i < old.size(); i++) {
+            if(!seen[i]) {
+                diff.kind = diff_removed;
+                diff.fields = 0;
+                diff.before = &old[i];
+                diff.after = nullptr;
+                stats_.removed++;
+                if(!visit(diff)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    
+    // reports every difference between the files at before and after
+    bool Reconciler::run(const char* before, const char* after, const std::function<bool(const Difference&)>& visit) {
+        
+        error_.clear();
+        memset(&stats_, 0, sizeof(stats_));
+        
+        long long size = fileSize(before);
+        if(size < 0 || fileSize(after) < 0) {
+            error_.message("Unable to open inventory file");
+            return false;
+        }
+        
+        // the older file is the one held in memory, so it alone decides the partition count
+        long long bytes = (size / min_line_length + 1) * (long long)record_memory;
+        long long count = (bytes + (long long)memory_ - 1) / (long long)memory_;
+        if(count < 1) {
+            count = 1;
+        } else if(count > max_reconcile_partitions) {
+            count = max_reconcile_partitions;
+        }
+        stats_.partitions = (int)count;
+        
+        if(count == 1) {
+            RecordReader oldReader;
+            RecordReader newReader;
+            if(!oldReader.open(before) || !newReader.open(after)) {
+                error_.message("Unable to open inventory file");
+                return false;
+            }
+            bool done = compare([&](Record& rec) { return oldReader.next(rec); },
+                                [&](Record& rec) { return newReader.next(rec); }, visit);
+            stats_.errors = oldReader.errors() + newReader.errors();
+            return done || error_.isClear();
+        }
+        
+        std::vector<FILE*> oldParts(count, nullptr);
+        std::vector<FILE*> newParts(count, nullptr);
+        bool ok = true;
+        
+        for(int i = 0; i < count && ok; i++) {
+            oldParts[i] = tmpfile();
+            newParts[i] = tmpfile();
+            if(oldParts[i] == nullptr || newParts[i] == nullptr) {
+                error_.message("Unable to create reconcile partition");
+                ok = false;
+            }
+        }
+        
+        ok = ok && partition(before, oldParts.data(), (int)count) && partition(after, newParts.data(), (int)count);
+        
+        for(int i = 0; i < count && ok; i++) {
+            FILE* oldPart = oldParts[i];
+            FILE* newPart = newParts[i];
+            ok = compare([oldPart](Record& rec) { return fread(&rec, sizeof(Record), 1, oldPart) == 1; },
+                         [newPart](Record& rec) { return fread(&rec, sizeof(Record), 1, newPart) == 1; }, visit);
+        }
+        
+        for(int i = 0; i < count; i++) {
+            if(oldParts[i] != nullptr) {
+                fclose(oldParts[i]);
+            }
+            if(newParts[i] != nullptr) {
+                fclose(newParts[i]);
+            }
+        }
+        return ok || error_.isClear();
+    }
+    
+    // writes every difference to path
+    bool Reconciler::run(const char* before, const char* after, const char* path) {
+        
+        FILE* out = fopen(path, "w");
+        if(out == nullptr) {
+            error_.message("Unable to create diff file");
+            return false;
+        }
+        
+        char buf[max_difference_length];
+        bool ok = run(before, after, [&](const Difference& diff) {
+            int length = formatDifference(diff, buf);
+            return fwrite(buf, 1, length, out) == (size_t)length;
+        });
+        
+        bool failed = ferror(out) != 0;
+        if(fclose(out) != 0) {
+            failed = true;
+        }
+        
+        if(!ok) {
+            return false;
+        }
+        if(failed) {
+            error_.message("Unable to write diff file");
+            return false;
+        }
+        return true;
+    }
+    
+    const DiffStats& Reconciler::stats() const {
+        return stats_;
+    }
+    
+    // returns the error message of the last failed run, nullptr if there is none
+    const char* Reconciler::message() const {
+        return error_.message();
+    }
+    
+}
@@ -0,0 +1,93 @@
+/* --------------------------------------------
+ Description: This is the header file for Reconcile.cpp. It declares the Reconciler class which compares two inventory files written by store() and reports the skus added, removed and changed, field by field, in linear time: both files are streamed into hash partitions by sku so that only one partition of the older file is held in memory at a time.
+ ----------------------------------------------- */
+
+#ifndef AMA_RECONCILE_H_
+#define AMA_RECONCILE_H_
+
+#include <stdio.h>
+#include <functional>
+#include "ErrorState.h"
+#include "Record.h"
+
+namespace AMA {
+    
+    const size_t reconcile_memory = 256 << 20;
+    const int max_reconcile_partitions = 256;
+    
+    enum DiffKind {
+        diff_added = '+',
+        diff_removed = '-',
+        diff_changed = '~'
+    };
+    
+    // fields compared for a sku present in both files
+    enum DiffField {
+        diff_type = 1 << 0,
+        diff_name = 1 << 1,
+        diff_unit = 1 << 2,
+        diff_taxed = 1 << 3,
+        diff_price = 1 << 4,
+        diff_qty = 1 << 5,
+        diff_qtyNeeded = 1 << 6,
+        diff_expiry = 1 << 7
+    };
+    
+    struct Difference {
+        DiffKind kind;
+        unsigned fields;                        // DiffField bits that differ, 0 unless changed
+        const Record* before;                   // nullptr for an added sku
+        const Record* after;                    // nullptr for a removed sku
+    };
+    
+    struct DiffStats {
+        long long added;
+        long long removed;
+        long long changed;
+        long long unchanged;
+        long long errors;                       // lines of either file that did not parse
+        int partitions;
+    };
+    
+    // returns the DiffField bits that differ between before and after
+    unsigned compareRecords(const Record& before, const Record& after);
+    
+    // longest line written by formatDifference(), including the new line and the null terminator:
+    // "~," 2, sku 7, ",type=N>P" 9, ",name=" 6 + 2 * 10 + 1, ",unit=" 6 + 2 * 75 + 1, ",taxed=0>1" 10,
+    // ",price=" 7 + 2 * 13 (widest %g) + 1, ",qty=" 5 + 2 * 11 + 1, ",qtyNeeded=" 11 + 2 * 11 + 1,
+    // ",expiry=" 8 + 2 * 14 (a year of any day number) + 1 and "\n\0" 2 make 345
+    const int max_difference_length = 352;
+    
+    // writes diff as one line into buf, which must hold max_difference_length characters
+    // "+,record" or "-,record" in store() format, or "~,sku,field=old>new,..." for a change
+    int formatDifference(const Difference& diff, char* buf);
+    
+    class Reconciler {
+        
+        size_t memory_;
+        DiffStats stats_;
+        ErrorState error_;
+        
+        bool partition(const char* path, FILE** parts, int count);
+        bool compare(const std::function<bool(Record&)>& before, const std::function<bool(Record&)>& after,
+                     const std::function<bool(const Difference&)>& visit);
+        
+    public:
+        // memory bounds the size of the older file's records held at once
+        Reconciler(size_t memory = reconcile_memory);
+        
+        // reports every difference between the files at before and after in no particular order
+        // visit returns false to stop, a sku repeated in the older file keeps its last record
+        bool run(const char* before, const char* after, const std::function<bool(const Difference&)>& visit);
+        
+        // writes every difference to path, one formatDifference() line each
+        bool run(const char* before, const char* after, const char* path);
+        
+        const DiffStats& stats() const;
+        const char* message() const;
+        
+    };
+    
+}
+
+#endif
@@ -0,0 +1,262 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the functions that move a product between its object form and the flat Record used by snapshots and other bulk formats.
+ ----------------------------------------------- */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Perishable.h"
+#include "Record.h"
+#include "Schema.h"
+
+namespace AMA {
+    
+    // sets record to safe empty state
+    void clear(Record& rec) {
+        memset(&rec, 0, sizeof(Record));
+    }
+    
+    // copies the fields of a Product or Perishable into rec
+    bool toRecord(const iProduct& prd, Record& rec) {
+        
+        const Product* src = dynamic_cast<const Product*>(&prd);
+        
+        if(src == nullptr) {
+            return false;
+        }
+        
+        clear(rec);
+        
+        // name() returns nullptr for an empty name
+        const char* nm = prd.name();
+        
+        rec.type = src->type();
+        strncpy(rec.sku, src->sku(), max_sku_length);
+        strncpy(rec.name, nm == nullptr ? "" : nm, max_name_length);
+        strncpy(rec.unit, src->unit(), max_unit_length);
+        rec.taxed = src->taxed();
+        rec.price = src->price();
+        rec.qty = src->quantity();
+        rec.qtyNeeded = src->qtyNeeded();
+        
+        const Perishable* per = dynamic_cast<const Perishable*>(src);
+        
+        if(per != nullptr) {
+            rec.expiry = per->expiry().dayNumber();
+        }
+        
+        return true;
+    }
+    
+    // replaces the fields of prd with the fields in rec
+    bool fromRecord(const Record& rec, iProduct& prd) {
+        
+        Product* dst = dynamic_cast<Product*>(&prd);
+        
+        if(dst == nullptr) {
+            return false;
+        }
+        
+        // init() keeps the type of dst and takes negative values, which the public constructor turns into an empty product
+        delete [] dst->name_;
+        if(!dst->init(rec.sku, rec.name, rec.unit, rec.qty, rec.taxed, rec.price, rec.qtyNeeded)) {
+            return false;
+        }
+        
+        Perishable* per = dynamic_cast<Perishable*>(dst);
+        
+        if(per != nullptr) {
+            per->expiry(Date::fromDayNumber(rec.expiry));
+        }
+        
+        return true;
+    }
+    
+    // returns the address of a new Product or Perishable holding the fields in rec
+    iProduct* createFromRecord(const Record& rec) {
+        
+        iProduct* prd;
+        
+        if(rec.type == 'P') {
+            prd = new Perishable();
+        } else {
+            prd = new Product(rec.type);
+        }
+        
+        fromRecord(rec, *prd);
+        
+        return prd;
+    }
+    
+    // copies field [begin, end) into buf of size characters
+    // returns false if the field does not fit
+    static bool copyField(const char* begin, const char* end, char* buf, size_t size) {
+        size_t length = end - begin;
+        if(length >= size) {
+            return false;
+        }
+        memcpy(buf, begin, length);
+        buf[length] = '\0';
+        return true;
+    }
+    
+    // parses an optionally signed decimal integer that fills [begin, end) and fits in an int
+    bool parseInt(const char* begin, const char* end, int& value) {
+        bool negative = false;
+        long long result = 0;
+        if(begin < end && (*begin == '-' || *begin == '+')) {
+            negative = *begin == '-';
+            begin++;
+        }
+        if(begin == end || end - begin > 10) {
+            return false;
+        }
+        for(; begin < end; begin++) {
+            if(*begin < '0' || *begin > '9') {
+                return false;
+            }
+            result = result * 10 + (*begin - '0');
+        }
+        if(negative) {
+            result = -result;
+        }
+        if(result < INT_MIN || result > INT_MAX) {
+            return false;
+        }
+        value = (int)result;
+        return true;
+    }
+    
+    // parses a floating point number that fills [begin, end)
+    bool parseDouble(const char* begin, const char* end, double& value) {
+        char buf[40];
+        char* stop;
+        if(begin == end || !copyField(begin, end, buf, sizeof(buf))) {
+            return false;
+        }
+        value = strtod(buf, &stop);
+        return *stop == '\0';
+    }
+    
+    // parses a date in YYYY/MM/DD format with the same limits as Date::read()
+    bool parseDate(const char* begin, const char* end, int& days) {
+        const char* sep1 = begin;
+        while(sep1 < end && *sep1 != '/' && *sep1 != '-') {
+            sep1++;
+        }
+        const char* sep2 = sep1 < end ? sep1 + 1 : end;
+        while(sep2 < end && *sep2 != '/' && *sep2 != '-') {
+            sep2++;
+        }
+        int year, month, day;
+        if(sep2 >= end || !parseInt(begin, sep1, year) || !parseInt(sep1 + 1, sep2, month) || !parseInt(sep2 + 1, end, day)) {
+            return false;
+        }
+        if(year < min_year || year > max_year || month < 1 || month > 12 || day < 1 || day > 31) {
+            return false;
+        }
+        // a day past the end of the month comes back as a different date
+        days = daysFromCivil(year, month, day);
+        int y, m, d;
+        civilFromDays(days, y, m, d);
+        return m == month && d == day;
+    }
+    
+    // parses one line in the format written by store(), the type in its first field decides which fields must follow
+    template <class Cursor>
+    static bool parseFields(const char* line, const char* end, Cursor& cursor, Record& rec) {
+        
+        clear(rec);
+        
+        bool valid;
+        if(end - line > 1 && line[0] == 'P' && line[1] == ',') {
+            valid = schema::parse<'P'>(cursor, rec);
+        } else {
+            valid = schema::parse<'N'>(cursor, rec);
+        }
+        
+        if(!valid) {
+            clear(rec);
+        }
+        
+        return valid;
+    }
+    
+    // parses one line in the format written by store()
+    bool parseRecord(const char* line, size_t length, Record& rec) {
+        
+        const char* end = line + length;
+        
+        // strips a carriage return left by files written on Windows
+        if(end > line && end[-1] == '\r') {
+            end--;
+        }
+        
+        schema::LineCursor cursor(line, end);
+        return parseFields(line, end, cursor, rec);
+    }
+    
+    // parses one line whose comma offsets are already known
+    bool parseRecord(const char* data, size_t begin, size_t end, const uint32_t* commas, int count, Record& rec) {
+        
+        if(count < 7 || count > 8) {
+            return false;
+        }
+        if(end > begin && data[end - 1] == '\r') {
+            end--;
+        }
+        
+        schema::IndexCursor cursor(data, begin, end, commas, count);
+        return parseFields(data + begin, data + end, cursor, rec);
+    }
+    
+    // writes rec into buf in the format written by store(), followed by a new line character
+    int formatRecord(const Record& rec, char* buf) {
+        
+        char* end = rec.type == 'P' ? schema::format<'P'>(rec, buf) : schema::format<'N'>(rec, buf);
+        
+        *end++ = '\n';
+        
+        return (int)(end - buf);
+    }
+    
+    // appends rec in the binary layout of its type
+    void encodeRecord(const Record& rec, std::vector<uint8_t>& out) {
+        if(rec.type == 'P') {
+            schema::encode<'P'>(rec, out);
+        } else {
+            schema::encode<'N'>(rec, out);
+        }
+    }
+    
+    // decodes one record written by encodeRecord()
+    bool decodeRecord(const uint8_t*& data, const uint8_t* end, Record& rec) {
+        
+        clear(rec);
+        
+        bool valid;
+        if(data < end && *data == 'P') {
+            valid = schema::decode<'P'>(data, end, rec);
+        } else {
+            valid = schema::decode<'N'>(data, end, rec);
+        }
+        
+        if(!valid) {
+            clear(rec);
+        }
+        
+        return valid;
+    }
+    
+    // writes rec into buf in the layout of write(os, true), followed by a new line character
+    int reportRecord(const Record& rec, char* buf) {
+        
+        char* end = rec.type == 'P' ? schema::report<'P'>(rec, buf) : schema::report<'N'>(rec, buf);
+        
+        *end++ = '\n';
+        
+        return (int)(end - buf);
+    }
+    
+}
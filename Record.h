@@ -0,0 +1,74 @@
+/* --------------------------------------------
+ Description: This is the header file for Record.cpp. It declares a flat record holding every field of a product file record, and the functions that copy it to and from Product and Perishable objects.
+ ----------------------------------------------- */
+
+#ifndef AMA_RECORD_H_
+#define AMA_RECORD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "Product.h"
+
+namespace AMA {
+    
+    // plain copy of a single product, free of pointers so it can be copied as raw bytes
+    struct Record {
+        char type;                              // 'N' for Product, 'P' for Perishable
+        char sku[max_sku_length + 1];
+        char name[max_name_length + 1];
+        char unit[max_unit_length + 1];
+        bool taxed;
+        double price;
+        int qty;
+        int qtyNeeded;
+        int expiry;                             // Date::dayNumber() of expiry date, 0 if none
+    };
+    
+    // sets record to safe empty state
+    void clear(Record& rec);
+    
+    // copies the fields of a Product or Perishable into rec
+    // returns false if prd is not derived from Product
+    bool toRecord(const iProduct& prd, Record& rec);
+    
+    // replaces the fields of prd with the fields in rec
+    // returns false if prd is not derived from Product, or is left empty because the unit table is full
+    bool fromRecord(const Record& rec, iProduct& prd);
+    
+    // returns the address of a new Product or Perishable holding the fields in rec
+    iProduct* createFromRecord(const Record& rec);
+    
+    // field parsers used by parseRecord(), each field must fill [begin, end) exactly
+    bool parseInt(const char* begin, const char* end, int& value);
+    bool parseDouble(const char* begin, const char* end, double& value);
+    bool parseDate(const char* begin, const char* end, int& days);
+    
+    // longest line written by formatRecord(), including the new line character
+    const int max_record_length = 160;
+    
+    // parses one line in the format written by store(), without the new line character
+    // returns false if the line is not a valid record
+    bool parseRecord(const char* line, size_t length, Record& rec);
+    
+    // parses the line data[begin, end) whose comma offsets into data were already found by a scanner
+    bool parseRecord(const char* data, size_t begin, size_t end, const uint32_t* commas, int count, Record& rec);
+    
+    // writes rec into buf in the format written by store(), followed by a new line character
+    // buf must hold max_record_length characters, returns the number of characters written
+    int formatRecord(const Record& rec, char* buf);
+    
+    // appends rec in a compact binary form, decodeRecord() reads it back and moves data past it
+    void encodeRecord(const Record& rec, std::vector<uint8_t>& out);
+    bool decodeRecord(const uint8_t*& data, const uint8_t* end, Record& rec);
+    
+    // longest line written by reportRecord(), including the new line character
+    const int max_report_length = 192;
+    
+    // writes rec into buf in the layout of write(os, true), followed by a new line character
+    // buf must hold max_report_length characters, returns the number of characters written
+    int reportRecord(const Record& rec, char* buf);
+    
+}
+
+#endif
@@ -0,0 +1,161 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the RecordReader class. Lines are returned as pointers into the read buffer, so a record is never copied before it is parsed.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include "RecordReader.h"
+
+namespace AMA {
+    
+    // sets object to safe empty state with a read buffer of bufferSize characters
+    RecordReader::RecordReader(size_t bufferSize) : buffer_(bufferSize < max_record_length ? max_record_length : bufferSize) {
+        file_ = nullptr;
+        begin_ = 0;
+        end_ = 0;
+        offset_ = 0;
+        line_ = 0;
+        errors_ = 0;
+    }
+    
+    // closes any open file
+    RecordReader::~RecordReader() {
+        close();
+    }
+    
+    // opens the file at path for reading from its first record
+    bool RecordReader::open(const char* path) {
+        close();
+        file_ = fopen(path, "rb");
+        return file_ != nullptr;
+    }
+    
+    // continues reading from a file offset returned by offset()
+    bool RecordReader::seek(long long offset) {
+        if(file_ == nullptr || fseeko(file_, (off_t)offset, SEEK_SET) != 0) {
+            return false;
+        }
+        begin_ = 0;
+        end_ = 0;
+        offset_ = offset;
+        return true;
+    }
+    
+    // closes the file and returns to safe empty state
+    void RecordReader::close() {
+        if(file_ != nullptr) {
+            fclose(file_);
+        }
+        file_ = nullptr;
+        begin_ = 0;
+        end_ = 0;
+        offset_ = 0;
+        line_ = 0;
+        errors_ = 0;
+    }
+    
+    // returns true if a file is open
+    bool RecordReader::isOpen() const {
+        return file_ != nullptr;
+    }
+    
+    // moves the unread characters to the front of the buffer and reads more after them
+    // grows the buffer if a single line does not fit, returns false at end of file
+    bool RecordReader::fill() {
+        
+        if(file_ == nullptr) {
+            return false;
+        }
+        
+        if(begin_ > 0) {
+            memmove(&buffer_[0], &buffer_[begin_], end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+        
+        if(end_ == buffer_.size()) {
+            buffer_.resize(buffer_.size() * 2);
+        }
+        
+        size_t count = fread(&buffer_[end_], 1, buffer_.size() - end_, file_);
+        end_ += count;
+        
+        return count > 0;
+    }
+    
+    // points line at the next line without its new line character
+    // returns false at end of file
+    bool RecordReader::nextLine(const char*& line, size_t& length) {
+        
+        size_t scanned = begin_;
+        
+        for(;;) {
+            
+            const char* start = &buffer_[0] + begin_;
+            const char* nl = static_cast<const char*>(memchr(&buffer_[0] + scanned, '\n', end_ - scanned));
+            
+            if(nl != nullptr) {
+                line = start;
+                length = nl - start;
+                offset_ += length + 1;
+                begin_ += length + 1;
+                line_++;
+                return true;
+            }
+            
+            scanned = end_ - begin_;
+            
+            if(!fill()) {
+                
+                // last line without a new line character
+                if(end_ > begin_) {
+                    line = &buffer_[0] + begin_;
+                    length = end_ - begin_;
+                    offset_ += length;
+                    begin_ = end_;
+                    line_++;
+                    return true;
+                }
+                return false;
+            }
+            
+            // fill() moved the unread characters to the front of the buffer
+            scanned += begin_;
+        }
+    }
+    
+    // parses the next valid record into rec, skipping blank and malformed lines
+    // returns false at end of file
+    bool RecordReader::next(Record& rec) {
+        
+        const char* line;
+        size_t length;
+        
+        while(nextLine(line, length)) {
+            if(length == 0 || (length == 1 && line[0] == '\r')) {
+                continue;
+            }
+            if(parseRecord(line, length, rec)) {
+                return true;
+            }
+            errors_++;
+        }
+        
+        return false;
+    }
+    
+    // returns the file offset of the next unread line
+    long long RecordReader::offset() const {
+        return offset_;
+    }
+    
+    // returns the number of lines read so far
+    long long RecordReader::line() const {
+        return line_;
+    }
+    
+    // returns the number of malformed lines skipped by next()
+    long long RecordReader::errors() const {
+        return errors_;
+    }
+    
+}
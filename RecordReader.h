@@ -0,0 +1,50 @@
+/* --------------------------------------------
+ Description: This is the header file for RecordReader.cpp. It declares the RecordReader class which reads a file written by store() in large blocks and hands back one line or one parsed Record at a time.
+ ----------------------------------------------- */
+
+#ifndef AMA_RECORDREADER_H_
+#define AMA_RECORDREADER_H_
+
+#include <stdio.h>
+#include <vector>
+#include "Record.h"
+
+namespace AMA {
+    
+    const size_t record_buffer_size = 1 << 20;
+    
+    class RecordReader {
+        
+        FILE* file_;
+        std::vector<char> buffer_;
+        size_t begin_;                          // first unread character in buffer_
+        size_t end_;                            // one past the last valid character in buffer_
+        long long offset_;                      // file offset of buffer_[begin_]
+        long long line_;
+        long long errors_;
+        
+        bool fill();
+        
+    public:
+        RecordReader(size_t bufferSize = record_buffer_size);
+        RecordReader(const RecordReader&) = delete;
+        RecordReader& operator=(const RecordReader&) = delete;
+        ~RecordReader();
+        
+        bool open(const char* path);
+        bool seek(long long offset);
+        void close();
+        bool isOpen() const;
+        
+        bool nextLine(const char*& line, size_t& length);
+        bool next(Record& rec);
+        
+        long long offset() const;
+        long long line() const;
+        long long errors() const;
+        
+    };
+    
+}
+
+#endif
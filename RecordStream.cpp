@@ -0,0 +1,130 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the RecordStream class. The stream holds one record and one read buffer however long the file is, so it runs in constant memory.
+ ----------------------------------------------- */
+
+#include "RecordStream.h"
+
+namespace AMA {
+    
+    // iterator at the current record of stream, or past the end if stream is nullptr
+    RecordStream::iterator::iterator(RecordStream* stream) {
+        stream_ = stream;
+    }
+    
+    // returns the current record
+    const Record& RecordStream::iterator::operator*() const {
+        return stream_->current();
+    }
+    
+    // returns the address of the current record
+    const Record* RecordStream::iterator::operator->() const {
+        return &stream_->current();
+    }
+    
+    // moves to the next record, becoming the end iterator when the stream runs out
+    RecordStream::iterator& RecordStream::iterator::operator++() {
+        if(stream_ != nullptr && !stream_->next()) {
+            stream_ = nullptr;
+        }
+        return *this;
+    }
+    
+    // iterators are equal if both are at the end or both belong to the same stream
+    bool RecordStream::iterator::operator==(const iterator& rhs) const {
+        return stream_ == rhs.stream_;
+    }
+    
+    bool RecordStream::iterator::operator!=(const iterator& rhs) const {
+        return stream_ != rhs.stream_;
+    }
+    
+    // sets stream to safe empty state
+    RecordStream::RecordStream(size_t bufferSize) : reader_(bufferSize) {
+        clear(rec_);
+        valid_ = false;
+        checkpoint_ = 0;
+    }
+    
+    // opens path positioned at offset
+    bool RecordStream::open(const char* path, long long offset) {
+        valid_ = false;
+        checkpoint_ = offset;
+        return reader_.open(path) && (offset == 0 || reader_.seek(offset));
+    }
+    
+    // closes the file, keeping the stages for the next open()
+    void RecordStream::close() {
+        reader_.close();
+        valid_ = false;
+    }
+    
+    // drops records for which filter returns false
+    RecordStream& RecordStream::where(const std::function<bool(const Record&)>& filter) {
+        stages_.push_back([filter](Record& rec) {
+            return filter(rec);
+        });
+        return *this;
+    }
+    
+    // drops records that do not match query
+    RecordStream& RecordStream::where(const Query& query) {
+        stages_.push_back([query](Record& rec) {
+            return query.matches(rec);
+        });
+        return *this;
+    }
+    
+    // changes every record that reaches this stage
+    RecordStream& RecordStream::transform(const std::function<void(Record&)>& fn) {
+        stages_.push_back([fn](Record& rec) {
+            fn(rec);
+            return true;
+        });
+        return *this;
+    }
+    
+    // reads records until one passes every stage
+    // returns false at end of file
+    bool RecordStream::next() {
+        
+        while(reader_.next(rec_)) {
+            
+            checkpoint_ = reader_.offset();
+            
+            bool keep = true;
+            for(size_t i = 0; i < stages_.size() && keep; i++) {
+                keep = stages_[i](rec_);
+            }
+            
+            if(keep) {
+                valid_ = true;
+                return true;
+            }
+        }
+        
+        checkpoint_ = reader_.offset();
+        valid_ = false;
+        return false;
+    }
+    
+    // returns the current record
+    const Record& RecordStream::current() const {
+        return rec_;
+    }
+    
+    // returns the offset to reopen at to continue after the current record
+    long long RecordStream::checkpoint() const {
+        return checkpoint_;
+    }
+    
+    // reads the first record and returns an iterator at it
+    RecordStream::iterator RecordStream::begin() {
+        return iterator(next() ? this : nullptr);
+    }
+    
+    // returns the end iterator
+    RecordStream::iterator RecordStream::end() {
+        return iterator();
+    }
+    
+}
@@ -0,0 +1,73 @@
+/* --------------------------------------------
+ Description: This is the header file for RecordStream.cpp. It declares the RecordStream class, a lazy range over the records of a file written by store(). Records are parsed one at a time into a single reused Record, can be filtered and transformed on the way, and a stream can be resumed from the offset of any record it has produced.
+ ----------------------------------------------- */
+
+#ifndef AMA_RECORDSTREAM_H_
+#define AMA_RECORDSTREAM_H_
+
+#include <functional>
+#include <iterator>
+#include <vector>
+#include "Query.h"
+#include "RecordReader.h"
+
+namespace AMA {
+    
+    class RecordStream {
+        
+        RecordReader reader_;
+        Record rec_;
+        std::vector<std::function<bool(Record&)> > stages_;
+        bool valid_;                            // rec_ holds a record that passed every stage
+        long long checkpoint_;                  // offset just past rec_
+        
+    public:
+        
+        // input iterator over the stream, every iterator shares the stream's single record
+        class iterator {
+            
+            RecordStream* stream_;
+            
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef Record value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Record* pointer;
+            typedef const Record& reference;
+            
+            explicit iterator(RecordStream* stream = nullptr);
+            reference operator*() const;
+            pointer operator->() const;
+            iterator& operator++();
+            bool operator==(const iterator& rhs) const;
+            bool operator!=(const iterator& rhs) const;
+            
+        };
+        
+        RecordStream(size_t bufferSize = record_buffer_size);
+        RecordStream(const RecordStream&) = delete;
+        RecordStream& operator=(const RecordStream&) = delete;
+        
+        // opens path positioned at offset, which is 0 or a value returned by checkpoint()
+        bool open(const char* path, long long offset = 0);
+        void close();
+        
+        // stages run in the order they were added, a record dropped by a filter skips later stages
+        RecordStream& where(const std::function<bool(const Record&)>& filter);
+        RecordStream& where(const Query& query);
+        RecordStream& transform(const std::function<void(Record&)>& fn);
+        
+        bool next();
+        const Record& current() const;
+        
+        // returns the offset to reopen at to continue after the current record
+        long long checkpoint() const;
+        
+        iterator begin();
+        iterator end();
+        
+    };
+    
+}
+
+#endif
@@ -0,0 +1,329 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the Reloader class. A reload matches the leading and trailing blocks of the new file against the previous one, widens the unchanged head and tail to whole lines, and shifts the products of the tail by the change in file size. Only the lines in between are hashed; a line whose hash matches the product of its sku is skipped, and only changed or new lines are parsed.
+ ----------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <unordered_map>
+#include "Record.h"
+#include "Reload.h"
+#include "SkuIndex.h"
+
+namespace AMA {
+    
+    namespace {
+        
+        const uint64_t mix = 0x9E3779B97F4A7C15ull;
+        
+        // returns a 64-bit hash of size bytes, eight at a time
+        uint64_t hashBytes(const char* data, size_t size) {
+            uint64_t h = size * mix;
+            uint64_t word;
+            while(size >= 8) {
+                memcpy(&word, data, 8);
+                h = (h ^ word) * mix;
+                h ^= h >> 29;
+                data += 8;
+                size -= 8;
+            }
+            word = 0;
+            memcpy(&word, data, size);
+            h = (h ^ word) * mix;
+            return h ^ (h >> 32);
+        }
+        
+        // hashes the full blocks of data from the start and from the end
+        void fingerprint(const std::string& data, std::vector<uint64_t>& head, std::vector<uint64_t>& tail) {
+            size_t blocks = data.size() / reload_block_size;
+            head.resize(blocks);
+            tail.resize(blocks);
+            for(size_t i = 0; i < blocks; i++) {
+                head[i] = hashBytes(data.data() + i * reload_block_size, reload_block_size);
+                tail[i] = hashBytes(data.data() + data.size() - (i + 1) * reload_block_size, reload_block_size);
+            }
+        }
+        
+        // returns the number of leading hashes the two lists share
+        size_t matching(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+            size_t n = 0;
+            while(n < a.size() && n < b.size() && a[n] == b[n]) {
+                n++;
+            }
+            return n;
+        }
+        
+        // reads the sku field of line into key, false if the line has none
+        bool skuKey(const char* line, const char* end, uint64_t& key) {
+            const char* sku = static_cast<const char*>(memchr(line, ',', end - line));
+            if(sku == nullptr) {
+                return false;
+            }
+            sku++;
+            const char* stop = static_cast<const char*>(memchr(sku, ',', end - sku));
+            if(stop == nullptr || stop == sku || stop - sku > max_sku_length) {
+                return false;
+            }
+            char text[max_sku_length + 1];
+            memcpy(text, sku, stop - sku);
+            text[stop - sku] = '\0';
+            key = SkuIndex::pack(text);
+            return true;
+        }
+        
+        // reads the whole file at path into data
+        bool readFile(const char* path, std::string& data) {
+            FILE* file = fopen(path, "rb");
+            if(file == nullptr) {
+                return false;
+            }
+            bool ok = fseek(file, 0, SEEK_END) == 0;
+            long size = ok ? ftell(file) : -1;
+            ok = size >= 0 && fseek(file, 0, SEEK_SET) == 0;
+            if(ok) {
+                data.resize((size_t)size);
+                ok = size == 0 || fread(&data[0], 1, (size_t)size, file) == (size_t)size;
+            }
+            fclose(file);
+            return ok;
+        }
+        
+        // replaces the fields of prd with rec, or replaces prd by a new product when the type changed
+        void update(iProduct*& prd, const Record& rec) {
+            const Product* current = dynamic_cast<const Product*>(prd);
+            if(current != nullptr && current->type() == rec.type) {
+                fromRecord(rec, *prd);
+            } else {
+                delete prd;
+                prd = createFromRecord(rec);
+            }
+        }
+    
+    }
+    
+    Reloader::Reloader() : size_(0), rest_(0) {
+        memset(&stats_, 0, sizeof(stats_));
+    }
+    
+    // re-parses the lines between the unchanged head and tail of the file and updates products to match
+    bool Reloader::reload(const char* path, std::vector<iProduct*>& products) {
+        
+        error_.clear();
+        memset(&stats_, 0, sizeof(stats_));
+        
+        if(products.size() != entries_.size()) {
+            error_.message("Inventory was changed outside reload()");
+            return false;
+        }
+        
+        std::string data;
+        data.swap(data_);
+        if(!readFile(path, data)) {
+            data.swap(data_);
+            error_.message("Cannot read inventory file");
+            return false;
+        }
+        
+        std::vector<uint64_t> head;
+        std::vector<uint64_t> tail;
+        fingerprint(data, head, tail);
+        
+        const char* text = data.data();
+        size_t size = data.size();
+        size_t oldSize = size_;
+        
+        uint64_t rest = hashBytes(text + size - size % reload_block_size, size % reload_block_size);
+        
+        if(size == oldSize && rest == rest_ && head == head_ && tail == tail_) {
+            stats_.unchanged = (long long)entries_.size();
+            data.swap(data_);
+            return true;
+        }
+        
+        // the head ends after the last new line inside the matching blocks
+        size_t prefix = matching(head, head_) * reload_block_size;
+        if(entries_.empty()) {
+            prefix = 0;
+        }
+        while(prefix > 0 && text[prefix - 1] != '\n') {
+            prefix--;
+        }
+        
+        // the tail starts after the first new line inside the matching blocks, which both files must hold past the head
+        size_t suffix = entries_.empty() ? 0 : matching(tail, tail_) * reload_block_size;
+        suffix = std::min(suffix, std::min(size, oldSize) - prefix);
+        size_t start = size;
+        if(suffix > 0) {
+            const char* nl = static_cast<const char*>(memchr(text + size - suffix, '\n', suffix));
+            if(nl != nullptr) {
+                start = nl - text + 1;
+            }
+        }
+        size_t oldStart = start + oldSize - size;
+        
+        // the products of the old lines between the head and the tail
+        size_t first = std::partition_point(entries_.begin(), entries_.end(), [&](const Entry& e) {
+            return e.offset < prefix;
+        }) - entries_.begin();
+        size_t last = std::partition_point(entries_.begin() + first, entries_.end(), [&](const Entry& e) {
+            return e.offset < oldStart;
+        }) - entries_.begin();
+        
+        std::unordered_map<uint64_t, size_t> middle;
+        middle.reserve(last - first);
+        for(size_t i = first; i < last; i++) {
+            middle[entries_[i].key] = i;
+        }
+        std::vector<bool> taken(last - first, false);
+        
+        std::vector<Entry> entries;
+        std::vector<Entry> duplicates;
+        std::vector<iProduct*> updated;
+        Record rec;
+        
+        for(size_t p = prefix; p < start; ) {
+            
+            const char* line = text + p;
+            const char* nl = static_cast<const char*>(memchr(line, '\n', start - p));
+            const char* end = nl == nullptr ? text + start : nl;
+            p = end - text + 1;
+            stats_.scanned += end - line + 1;
+            
+            if(end == line || (end - line == 1 && *line == '\r')) {
+                continue;
+            }
+            
+            Entry entry;
+            entry.offset = line - text;
+            entry.hash = hashBytes(line, end - line);
+            
+            if(!skuKey(line, end, entry.key)) {
+                stats_.invalid++;
+                continue;
+            }
+            
+            auto it = middle.find(entry.key);
+            if(it != middle.end() && !taken[it->second - first]) {
+                
+                size_t i = it->second;
+                iProduct* prd = products[i];
+                taken[i - first] = true;
+                
+                if(entry.hash != entries_[i].hash) {
+                    if(parseRecord(line, end - line, rec)) {
+                        update(prd, rec);
+                        stats_.changed++;
+                    } else {
+                        // keeps the old hash so the line is parsed again once it is fixed
+                        entry.hash = entries_[i].hash;
+                        stats_.invalid++;
+                    }
+                } else {
+                    stats_.unchanged++;
+                }
+                
+                entries.push_back(entry);
+                updated.push_back(prd);
+                
+            } else if(keys_.count(entry.key) != 0) {
+                duplicates.push_back(entry);
+                stats_.duplicates++;
+            } else if(parseRecord(line, end - line, rec)) {
+                keys_.insert(entry.key);
+                entries.push_back(entry);
+                updated.push_back(createFromRecord(rec));
+                stats_.added++;
+            } else {
+                stats_.invalid++;
+            }
+        }
+        
+        // products whose sku left the changed lines
+        std::vector<uint64_t> removed;
+        for(size_t i = first; i < last; i++) {
+            if(!taken[i - first]) {
+                keys_.erase(entries_[i].key);
+                removed.push_back(entries_[i].key);
+                delete products[i];
+                stats_.removed++;
+            }
+        }
+        
+        // the tail moves by the change in file size
+        for(size_t i = last; i < entries_.size(); i++) {
+            entries_[i].offset = entries_[i].offset + size - oldSize;
+        }
+        stats_.unchanged += (long long)(first + entries_.size() - last);
+        
+        entries_.erase(entries_.begin() + first, entries_.begin() + last);
+        entries_.insert(entries_.begin() + first, entries.begin(), entries.end());
+        products.erase(products.begin() + first, products.begin() + last);
+        products.insert(products.begin() + first, updated.begin(), updated.end());
+        
+        // the duplicates of the changed lines were found again, those of the head and tail are kept
+        size_t dupFirst = std::partition_point(duplicates_.begin(), duplicates_.end(), [&](const Entry& e) {
+            return e.offset < prefix;
+        }) - duplicates_.begin();
+        size_t dupLast = std::partition_point(duplicates_.begin() + dupFirst, duplicates_.end(), [&](const Entry& e) {
+            return e.offset < oldStart;
+        }) - duplicates_.begin();
+        for(size_t i = dupLast; i < duplicates_.size(); i++) {
+            duplicates_[i].offset = duplicates_[i].offset + size - oldSize;
+        }
+        duplicates_.erase(duplicates_.begin() + dupFirst, duplicates_.begin() + dupLast);
+        duplicates_.insert(duplicates_.begin() + dupFirst, duplicates.begin(), duplicates.end());
+        
+        // a removed sku still in the file takes the first of its remaining lines
+        for(size_t r = 0; r < removed.size() && !duplicates_.empty(); r++) {
+            for(size_t i = 0; i < duplicates_.size(); ) {
+                if(duplicates_[i].key != removed[r]) {
+                    i++;
+                    continue;
+                }
+                Entry entry = duplicates_[i];
+                duplicates_.erase(duplicates_.begin() + i);
+                const char* line = text + entry.offset;
+                const char* nl = static_cast<const char*>(memchr(line, '\n', size - entry.offset));
+                if(parseRecord(line, (nl == nullptr ? text + size : nl) - line, rec)) {
+                    size_t at = std::partition_point(entries_.begin(), entries_.end(), [&](const Entry& e) {
+                        return e.offset < entry.offset;
+                    }) - entries_.begin();
+                    keys_.insert(entry.key);
+                    entries_.insert(entries_.begin() + at, entry);
+                    products.insert(products.begin() + at, createFromRecord(rec));
+                    stats_.removed--;
+                    stats_.changed++;
+                    break;
+                }
+            }
+        }
+        
+        head_.swap(head);
+        tail_.swap(tail);
+        size_ = size;
+        rest_ = rest;
+        data.swap(data_);
+        return true;
+    }
+    
+    // forgets the previous file
+    void Reloader::clear() {
+        entries_.clear();
+        duplicates_.clear();
+        keys_.clear();
+        head_.clear();
+        tail_.clear();
+        size_ = 0;
+        rest_ = 0;
+        data_.clear();
+    }
+    
+    const ReloadStats& Reloader::stats() const {
+        return stats_;
+    }
+    
+    const char* Reloader::message() const {
+        return error_.message();
+    }
+    
+}
@@ -0,0 +1,71 @@
+/* --------------------------------------------
+ Description: This is the header file for Reload.cpp. It declares the Reloader class which keeps an inventory of products in step with a file written by store(), re-parsing only what changed since the previous reload. The file is fingerprinted in fixed blocks from both ends so the unchanged head and tail are skipped without reading their lines, and every record in between is matched to its product by sku and compared by the hash of its line.
+ ----------------------------------------------- */
+
+#ifndef AMA_RELOAD_H_
+#define AMA_RELOAD_H_
+
+#include <stdint.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "ErrorState.h"
+#include "iProduct.h"
+
+namespace AMA {
+    
+    // bytes in each fingerprinted block of the file
+    const size_t reload_block_size = 64 << 10;
+    
+    struct ReloadStats {
+        long long unchanged;                    // products whose line was not re-parsed
+        long long changed;                      // products updated from a line that changed
+        long long added;
+        long long removed;
+        long long invalid;                      // lines that did not parse, a product whose line broke keeps its values
+        long long duplicates;                   // lines repeating a sku that already has a product, ignored while it has one
+        long long scanned;                      // bytes of lines read between the unchanged head and tail
+    };
+    
+    class Reloader {
+        
+        // one product of the inventory, in the order of the file
+        struct Entry {
+            uint64_t key;                       // SkuIndex::pack() of the sku
+            uint64_t hash;                      // hash of the line the product was parsed from
+            size_t offset;                      // start of that line in the file
+        };
+        
+        std::vector<Entry> entries_;
+        std::vector<Entry> duplicates_;         // ignored lines whose sku already has a product, in the order of the file
+        std::unordered_set<uint64_t> keys_;
+        std::vector<uint64_t> head_;            // hashes of the full blocks counted from the start of the file
+        std::vector<uint64_t> tail_;            // hashes of the full blocks counted from the end
+        size_t size_;
+        uint64_t rest_;                         // hash of the bytes after the last full block
+        std::string data_;                      // buffer the file is read into, kept between reloads
+        ReloadStats stats_;
+        ErrorState error_;
+        
+    public:
+        Reloader();
+        Reloader(const Reloader&) = delete;
+        Reloader& operator=(const Reloader&) = delete;
+        
+        // brings products in line with the file at path, which holds one store() record per line
+        // products must be empty on the first call and changed only by reload() afterwards
+        // it is left in the order of the file, products created by reload() are freed with delete
+        // a product whose line is removed moves to a remaining duplicate of its sku, if there is one
+        bool reload(const char* path, std::vector<iProduct*>& products);
+        
+        // forgets the previous file, so the next reload() starts from an empty inventory
+        void clear();
+        
+        const ReloadStats& stats() const;
+        const char* message() const;
+        
+    };
+    
+}
+
+#endif
@@ -0,0 +1,239 @@
+/* --------------------------------------------
+ Description: This implementation file contains the scalar, SSE2 and AVX2 versions of the structural scanner and the StructuralIndex class. The vector versions compare 16 or 32 characters at once against the delimiter and '\n', turn the matches into a bit mask and write one offset per set bit.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include "Scanner.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AMA_SCAN_X86 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define AMA_SCAN_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace AMA {
+    
+    namespace {
+        
+        // returns the index of the lowest set bit of a non-zero mask
+        inline int lowestBit(uint32_t mask) {
+#if defined(__GNUC__)
+            return __builtin_ctz(mask);
+#else
+            int bit = 0;
+            while(!(mask & 1)) {
+                mask >>= 1;
+                bit++;
+            }
+            return bit;
+#endif
+        }
+        
+        // writes base plus the position of each set bit of mask to out
+        inline size_t emit(uint32_t mask, uint32_t base, uint32_t* out) {
+            size_t count = 0;
+            while(mask != 0) {
+                out[count++] = base + lowestBit(mask);
+                mask &= mask - 1;
+            }
+            return count;
+        }
+        
+        size_t scanScalar(const char* data, size_t from, size_t size, char delimiter, uint32_t* out) {
+            size_t count = 0;
+            for(size_t i = from; i < size; i++) {
+                if(data[i] == delimiter || data[i] == '\n') {
+                    out[count++] = (uint32_t)i;
+                }
+            }
+            return count;
+        }
+        
+#if AMA_SCAN_X86
+        size_t scanSse2(const char* data, size_t size, char delimiter, uint32_t* out) {
+            const __m128i delim = _mm_set1_epi8(delimiter);
+            const __m128i newline = _mm_set1_epi8('\n');
+            size_t count = 0;
+            size_t i = 0;
+            for(; i + 16 <= size; i += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, delim), _mm_cmpeq_epi8(chunk, newline));
+                count += emit((uint32_t)_mm_movemask_epi8(hits), (uint32_t)i, out + count);
+            }
+            return count + scanScalar(data, i, size, delimiter, out + count);
+        }
+#endif
+        
+#if AMA_SCAN_AVX2
+        __attribute__((target("avx2")))
+        size_t scanAvx2(const char* data, size_t size, char delimiter, uint32_t* out) {
+            const __m256i delim = _mm256_set1_epi8(delimiter);
+            const __m256i newline = _mm256_set1_epi8('\n');
+            size_t count = 0;
+            size_t i = 0;
+            
+            // two vectors per step so that the mask of 64 characters is built before any offset is written
+            for(; i + 64 <= size; i += 64) {
+                __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+                uint32_t loMask = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(lo, delim), _mm256_cmpeq_epi8(lo, newline)));
+                uint32_t hiMask = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(hi, delim), _mm256_cmpeq_epi8(hi, newline)));
+                count += emit(loMask, (uint32_t)i, out + count);
+                count += emit(hiMask, (uint32_t)i + 32, out + count);
+            }
+            return count + scanScalar(data, i, size, delimiter, out + count);
+        }
+#endif
+        
+    }
+    
+    // returns the fastest level the processor supports
+    ScanLevel scanLevel() {
+#if AMA_SCAN_AVX2
+        static const ScanLevel level = __builtin_cpu_supports("avx2") ? scan_avx2 : scan_sse2;
+        return level;
+#elif AMA_SCAN_X86
+        return scan_sse2;
+#else
+        return scan_scalar;
+#endif
+    }
+    
+    const char* scanLevelName(ScanLevel level) {
+        switch(level) {
+            case scan_avx2:
+                return "avx2";
+            case scan_sse2:
+                return "sse2";
+            default:
+                return "scalar";
+        }
+    }
+    
+    // writes the offset of every delimiter and '\n' in data to out
+    size_t scanStructure(const char* data, size_t size, char delimiter, uint32_t* out, ScanLevel level) {
+        if(level > scanLevel()) {
+            level = scanLevel();
+        }
+        switch(level) {
+#if AMA_SCAN_AVX2
+            case scan_avx2:
+                return scanAvx2(data, size, delimiter, out);
+#endif
+#if AMA_SCAN_X86
+            case scan_sse2:
+                return scanSse2(data, size, delimiter, out);
+#endif
+            default:
+                return scanScalar(data, 0, size, delimiter, out);
+        }
+    }
+    
+    // sets index to safe empty state
+    StructuralIndex::StructuralIndex() : count_(0), data_(nullptr), size_(0), next_(0), begin_(0) {
+        
+    }
+    
+    // indexes data and rewinds nextLine() to its first line
+    void StructuralIndex::build(const char* data, size_t size, char delimiter, ScanLevel level) {
+        
+        // resize() would zero every entry, so the vector only grows
+        if(offsets_.size() < size) {
+            offsets_.resize(size);
+        }
+        count_ = scanStructure(data, size, delimiter, offsets_.data(), level);
+        data_ = data;
+        size_ = size;
+        next_ = 0;
+        begin_ = 0;
+    }
+    
+    size_t StructuralIndex::size() const {
+        return count_;
+    }
+    
+    const uint32_t* StructuralIndex::offsets() const {
+        return offsets_.data();
+    }
+    
+    // returns the next line and its delimiters
+    bool StructuralIndex::nextLine(size_t& begin, size_t& end, const uint32_t*& delimiters, int& count) {
+        
+        if(begin_ >= size_) {
+            return false;
+        }
+        
+        size_t first = next_;
+        while(next_ < count_ && data_[offsets_[next_]] != '\n') {
+            next_++;
+        }
+        
+        begin = begin_;
+        delimiters = offsets_.data() + first;
+        count = (int)(next_ - first);
+        
+        if(next_ < count_) {
+            end = offsets_[next_];
+            next_++;
+        } else {
+            end = size_;
+        }
+        begin_ = end + 1;
+        return true;
+    }
+    
+    // parses every store() line of data through a StructuralIndex
+    // data is indexed a block of whole lines at a time so the offsets stay in cache while they are parsed
+    long long parseRecords(const char* data, size_t size, const std::function<bool(const Record&)>& visit, long long* errors) {
+        
+        StructuralIndex index;
+        size_t begin, end;
+        const uint32_t* commas;
+        int count;
+        long long parsed = 0;
+        long long failed = 0;
+        bool more = true;
+        Record rec;
+        
+        for(size_t pos = 0; pos < size && more; ) {
+            
+            // ends the block after its last new line, or takes the rest of a line longer than a block
+            size_t last = pos + scan_block_size < size ? pos + scan_block_size : size;
+            if(last < size) {
+                size_t cut = last;
+                while(cut > pos && data[cut - 1] != '\n') {
+                    cut--;
+                }
+                if(cut == pos) {
+                    const void* nl = memchr(data + last, '\n', size - last);
+                    cut = nl == nullptr ? size : (const char*)nl - data + 1;
+                }
+                last = cut;
+            }
+            
+            const char* block = data + pos;
+            index.build(block, last - pos);
+            while(more && index.nextLine(begin, end, commas, count)) {
+                if(end == begin || (end == begin + 1 && block[begin] == '\r')) {
+                    continue;
+                }
+                if(!parseRecord(block, begin, end, commas, count, rec)) {
+                    failed++;
+                    continue;
+                }
+                parsed++;
+                more = visit(rec);
+            }
+            pos = last;
+        }
+        
+        if(errors != nullptr) {
+            *errors = failed;
+        }
+        return parsed;
+    }
+    
+}
@@ -0,0 +1,64 @@
+/* --------------------------------------------
+ Description: This is the header file for Scanner.cpp. It declares the structural scanner which finds every field delimiter and new line character of a large buffer in one vectorised pass, using AVX2 or SSE2 when the processor has them, and the StructuralIndex class which holds the offsets it finds for a parser to walk.
+ ----------------------------------------------- */
+
+#ifndef AMA_SCANNER_H_
+#define AMA_SCANNER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <vector>
+#include "Record.h"
+
+namespace AMA {
+    
+    // characters parseRecords() indexes at a time
+    const size_t scan_block_size = 64 << 10;
+    
+    enum ScanLevel {
+        scan_scalar,
+        scan_sse2,
+        scan_avx2
+    };
+    
+    // returns the fastest level the processor supports
+    ScanLevel scanLevel();
+    const char* scanLevelName(ScanLevel level);
+    
+    // writes the offset of every delimiter and '\n' in data to out and returns how many were found
+    // out must hold size entries, a level the processor does not support falls back to a lower one
+    size_t scanStructure(const char* data, size_t size, char delimiter, uint32_t* out, ScanLevel level);
+    
+    class StructuralIndex {
+        
+        std::vector<uint32_t> offsets_;
+        size_t count_;
+        const char* data_;
+        size_t size_;
+        size_t next_;                           // first offset not yet returned by nextLine()
+        size_t begin_;                          // start of the next line
+        
+    public:
+        StructuralIndex();
+        
+        // indexes data, which must be smaller than 4GB and outlive the index
+        void build(const char* data, size_t size, char delimiter = ',', ScanLevel level = scanLevel());
+        
+        size_t size() const;
+        const uint32_t* offsets() const;
+        
+        // returns the next line [begin, end) and the offsets of the delimiters inside it
+        // a last line without a new line character is returned as well
+        bool nextLine(size_t& begin, size_t& end, const uint32_t*& delimiters, int& count);
+        
+    };
+    
+    // parses every store() line of data through a StructuralIndex, visit returns false to stop
+    // returns the number of records parsed, lines that do not parse are counted in errors
+    long long parseRecords(const char* data, size_t size, const std::function<bool(const Record&)>& visit,
+                           long long* errors = nullptr);
+    
+}
+
+#endif
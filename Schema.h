@@ -0,0 +1,771 @@
+/* --------------------------------------------
+ Description: This header declares the compile-time record schema used by formatRecord(), parseRecord(), encodeRecord(), reportRecord(), store() and the exporters. Each field of a record is a type that knows how to format, parse, encode, decode, report and export itself; a layout is a list of field types, and the store(), binary, report and export layouts of N and P records are built from the same fields, so every format path is generated by the compiler from one description and the paths cannot drift apart.
+ ----------------------------------------------- */
+
+#ifndef AMA_SCHEMA_H_
+#define AMA_SCHEMA_H_
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "BitStream.h"
+#include "Date.h"
+#include "Record.h"
+
+namespace AMA {
+    
+    namespace schema {
+        
+        // widest cost reportRecord() writes, a larger price is cut short
+        const int max_cost_length = 32;
+        
+        // writes value in decimal and returns the end of the digits
+        inline char* putInt(char* p, int value) {
+            char digits[12];
+            int n = 0;
+            unsigned magnitude = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+            do {
+                digits[n++] = (char)('0' + magnitude % 10);
+                magnitude /= 10;
+            } while(magnitude != 0);
+            if(value < 0) {
+                *p++ = '-';
+            }
+            while(n > 0) {
+                *p++ = digits[--n];
+            }
+            return p;
+        }
+        
+        inline char* putString(char* p, const char* str) {
+            size_t length = strlen(str);
+            memcpy(p, str, length);
+            return p + length;
+        }
+        
+        // writes str left aligned in width characters, like std::left with os.width(width)
+        inline char* putLeft(char* p, const char* str, int width) {
+            char* start = p;
+            p = putString(p, str);
+            while(p - start < width) {
+                *p++ = ' ';
+            }
+            return p;
+        }
+        
+        // writes value right aligned in width characters, like std::right with os.width(width)
+        inline char* putRight(char* p, int value, int width) {
+            char digits[12];
+            int length = (int)(putInt(digits, value) - digits);
+            for(int i = length; i < width; i++) {
+                *p++ = ' ';
+            }
+            memcpy(p, digits, length);
+            return p + length;
+        }
+        
+        // returns the first comma in [p, end), end if there is none
+        inline const char* nextComma(const char* p, const char* end) {
+            const void* comma = memchr(p, ',', end - p);
+            return comma == nullptr ? end : static_cast<const char*>(comma);
+        }
+        
+        // copies [begin, end) into a field of Size characters including its terminator
+        template <size_t Size>
+        inline bool parseText(const char* begin, const char* end, char (&field)[Size]) {
+            size_t length = end - begin;
+            if(length >= Size) {
+                return false;
+            }
+            memcpy(field, begin, length);
+            field[length] = '\0';
+            return true;
+        }
+        
+        template <size_t Size>
+        inline void encodeText(const char (&field)[Size], std::vector<uint8_t>& out) {
+            size_t length = strnlen(field, Size - 1);
+            out.push_back((uint8_t)length);
+            out.insert(out.end(), field, field + length);
+        }
+        
+        template <size_t Size>
+        inline bool decodeText(const uint8_t*& data, const uint8_t* end, char (&field)[Size]) {
+            if(data == end || *data >= Size || (size_t)(end - data - 1) < *data) {
+                return false;
+            }
+            size_t length = *data++;
+            memcpy(field, data, length);
+            field[length] = '\0';
+            data += length;
+            return true;
+        }
+        
+        inline void encodeInt(int value, std::vector<uint8_t>& out) {
+            writeVarint(out, zigzag(value));
+        }
+        
+        inline bool decodeInt(const uint8_t*& data, const uint8_t* end, int& value) {
+            uint64_t raw;
+            if(!readVarint(data, end, raw)) {
+                return false;
+            }
+            value = (int)unzigzag(raw);
+            return true;
+        }
+        
+        // writes str as an RFC 4180 field, quoted only when it holds a comma, quote or line break
+        // plain text is copied in one pass, the field is rewritten quoted at the first special character
+        inline char* putCsv(char* p, const char* str) {
+            char* start = p;
+            for(const char* s = str; *s != '\0'; s++) {
+                if(*s == ',' || *s == '"' || *s == '\r' || *s == '\n') {
+                    p = start;
+                    *p++ = '"';
+                    for(; *str != '\0'; str++) {
+                        if(*str == '"') {
+                            *p++ = '"';
+                        }
+                        *p++ = *str;
+                    }
+                    *p++ = '"';
+                    return p;
+                }
+                *p++ = *s;
+            }
+            return p;
+        }
+        
+        // writes str as a JSON string, escaping quotes, backslashes and control characters
+        inline char* putJson(char* p, const char* str) {
+            static const char hex[] = "0123456789abcdef";
+            *p++ = '"';
+            for(; *str != '\0'; str++) {
+                unsigned char c = (unsigned char)*str;
+                if(c == '"' || c == '\\') {
+                    *p++ = '\\';
+                    *p++ = (char)c;
+                } else if(c < 0x20) {
+                    memcpy(p, "\\u00", 4);
+                    p[4] = hex[c >> 4];
+                    p[5] = hex[c & 15];
+                    p += 6;
+                } else {
+                    *p++ = (char)c;
+                }
+            }
+            *p++ = '"';
+            return p;
+        }
+        
+        // writes a Date::dayNumber() as YYYY-MM-DD
+        inline char* putIsoDate(char* p, int days) {
+            int year, month, day;
+            civilFromDays(days, year, month, day);
+            p = putInt(p, year);
+            *p++ = '-';
+            *p++ = (char)('0' + month / 10);
+            *p++ = (char)('0' + month % 10);
+            *p++ = '-';
+            *p++ = (char)('0' + day / 10);
+            *p++ = (char)('0' + day % 10);
+            return p;
+        }
+        
+        // writes a number of cents as whole units, a point and two decimals
+        inline char* putCentsOf(char* p, long long cents) {
+            unsigned long long magnitude = cents < 0 ? 0ull - (unsigned long long)cents : (unsigned long long)cents;
+            unsigned long long whole = magnitude / 100;
+            unsigned fraction = (unsigned)(magnitude % 100);
+            char digits[20];
+            int n = 0;
+            do {
+                digits[n++] = (char)('0' + whole % 10);
+                whole /= 10;
+            } while(whole != 0);
+            if(cents < 0) {
+                *p++ = '-';
+            }
+            while(n > 0) {
+                *p++ = digits[--n];
+            }
+            *p++ = '.';
+            *p++ = (char)('0' + fraction / 10);
+            *p++ = (char)('0' + fraction % 10);
+            return p;
+        }
+        
+        // writes value rounded to two decimals, without printf for values below 10 ^ 15 and with 17 digits above
+        inline char* putCents(char* p, double value) {
+            if(!(fabs(value) < 1e15)) {
+                return p + snprintf(p, max_cost_length, "%.17g", value);
+            }
+            return putCentsOf(p, llround(value * 100));
+        }
+        
+        // writes a price exactly: a whole number of cents without trailing zeros, anything else with 17 digits
+        inline char* putPrice(char* p, double value) {
+            if(fabs(value) < 1e13) {
+                long long cents = llround(value * 100);
+                if((double)cents / 100 == value) {
+                    p = putCentsOf(p, cents);
+                    if(p[-1] == '0') {
+                        p--;
+                        if(p[-1] == '0') {
+                            p -= 2;
+                        }
+                    }
+                    return p;
+                }
+            }
+            return p + snprintf(p, max_cost_length, "%.17g", value);
+        }
+        
+        // writes value, or null when it is not a finite number, for a JSON value
+        inline char* putJsonNumber(char* p, double value, char* (*put)(char*, double)) {
+            if(isfinite(value)) {
+                return put(p, value);
+            }
+            memcpy(p, "null", 4);
+            return p + 4;
+        }
+        
+        // the fields of a record, in no particular order
+        
+        struct TypeField {
+            static char* format(const Record& rec, char* p) {
+                *p++ = rec.type;
+                return p;
+            }
+            static bool parse(const char* begin, const char* end, Record& rec) {
+                if(end - begin != 1) {
+                    return false;
+                }
+                rec.type = *begin;
+                return true;
+            }
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                out.push_back((uint8_t)rec.type);
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                if(data == end) {
+                    return false;
+                }
+                rec.type = (char)*data++;
+                return true;
+            }
+            static const char* key() {
+                return "type";
+            }
+            static char* csv(const Record& rec, char* p) {
+                char type[2] = { rec.type, '\0' };
+                return putCsv(p, type);
+            }
+            static char* json(const Record& rec, char* p) {
+                char type[2] = { rec.type, '\0' };
+                return putJson(p, type);
+            }
+        };
+        
+        struct SkuField {
+            static char* format(const Record& rec, char* p) {
+                return putString(p, rec.sku);
+            }
+            static bool parse(const char* begin, const char* end, Record& rec) {
+                return parseText(begin, end, rec.sku);
+            }
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                encodeText(rec.sku, out);
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                return decodeText(data, end, rec.sku);
+            }
+            static char* report(const Record& rec, char* p) {
+                p = putLeft(p, rec.sku, max_sku_length);
+                *p++ = '|';
+                return p;
+            }
+            static const char* key() {
+                return "sku";
+            }
+            static char* csv(const Record& rec, char* p) {
+                return putCsv(p, rec.sku);
+            }
+            static char* json(const Record& rec, char* p) {
+                return putJson(p, rec.sku);
+            }
+        };
+        
+        struct NameField {
+            static char* format(const Record& rec, char* p) {
+                return putString(p, rec.name);
+            }
+            static bool parse(const char* begin, const char* end, Record& rec) {
+                return parseText(begin, end, rec.name);
+            }
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                encodeText(rec.name, out);
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                return decodeText(data, end, rec.name);
+            }
+            static char* report(const Record& rec, char* p) {
+                p = putLeft(p, rec.name, 20);
+                *p++ = '|';
+                return p;
+            }
+            static const char* key() {
+                return "name";
+            }
+            static char* csv(const Record& rec, char* p) {
+                return putCsv(p, rec.name);
+            }
+            static char* json(const Record& rec, char* p) {
+                return putJson(p, rec.name);
+            }
+        };
+        
+        struct UnitField {
+            static char* format(const Record& rec, char* p) {
+                return putString(p, rec.unit);
+            }
+            static bool parse(const char* begin, const char* end, Record& rec) {
+                return parseText(begin, end, rec.unit);
+            }
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                encodeText(rec.unit, out);
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                return decodeText(data, end, rec.unit);
+            }
+            static char* report(const Record& rec, char* p) {
+                p = putLeft(p, rec.unit, 10);
+                *p++ = '|';
+                return p;
+            }
+            static const char* key() {
+                return "unit";
+            }
+            static char* csv(const Record& rec, char* p) {
+                return putCsv(p, rec.unit);
+            }
+            static char* json(const Record& rec, char* p) {
+                return putJson(p, rec.unit);
+            }
+        };
+        
+        struct TaxedField {
+            static char* format(const Record& rec, char* p) {
+                *p++ = rec.taxed ? '1' : '0';
+                return p;
+            }
+            static bool parse(const char* begin, const char* end, Record& rec) {
+                int taxed;
+                if(!parseInt(begin, end, taxed) || (taxed != 0 && taxed != 1)) {
+                    return false;
+                }
+                rec.taxed = taxed == 1;
+                return true;
+            }
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                out.push_back(rec.taxed ? 1 : 0);
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                if(data == end || *data > 1) {
+                    return false;
+                }
+                rec.taxed = *data++ == 1;
+                return true;
+            }
+            static const char* key() {
+                return "taxed";
+            }
+            static char* csv(const Record& rec, char* p) {
+                return format(rec, p);
+            }
+            static char* json(const Record& rec, char* p) {
+                const char* text = rec.taxed ? "true" : "false";
+                size_t length = rec.taxed ? 4 : 5;
+                memcpy(p, text, length);
+                return p + length;
+            }
+        };
+        
+        struct PriceField {
+            
+            // %g matches the default precision used by the stream insertion in store()
+            static char* format(const Record& rec, char* p) {
+                return p + sprintf(p, "%g", rec.price);
+            }
+            static bool parse(const char* begin, const char* end, Record& rec) {
+                return parseDouble(begin, end, rec.price);
+            }
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                uint8_t bytes[sizeof(double)];
+                memcpy(bytes, &rec.price, sizeof(double));
+                out.insert(out.end(), bytes, bytes + sizeof(double));
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                if((size_t)(end - data) < sizeof(double)) {
+                    return false;
+                }
+                memcpy(&rec.price, data, sizeof(double));
+                data += sizeof(double);
+                return true;
+            }
+            
+            // reports the cost after tax, as Product::write() does
+            static char* report(const Record& rec, char* p) {
+                int length = snprintf(p, max_cost_length, "%7.2f|", rec.taxed ? rec.price * (1 + tax) : rec.price);
+                return p + (length < max_cost_length ? length : max_cost_length - 1);
+            }
+            static const char* key() {
+                return "price";
+            }
+            static char* csv(const Record& rec, char* p) {
+                return putPrice(p, rec.price);
+            }
+            static char* json(const Record& rec, char* p) {
+                return putJsonNumber(p, rec.price, putPrice);
+            }
+        };
+        
+        struct QtyField {
+            static char* format(const Record& rec, char* p) {
+                return putInt(p, rec.qty);
+            }
+            static bool parse(const char* begin, const char* end, Record& rec) {
+                return parseInt(begin, end, rec.qty);
+            }
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                encodeInt(rec.qty, out);
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                return decodeInt(data, end, rec.qty);
+            }
+            static char* report(const Record& rec, char* p) {
+                p = putRight(p, rec.qty, 4);
+                *p++ = '|';
+                return p;
+            }
+            static const char* key() {
+                return "qty";
+            }
+            static char* csv(const Record& rec, char* p) {
+                return putInt(p, rec.qty);
+            }
+            static char* json(const Record& rec, char* p) {
+                return putInt(p, rec.qty);
+            }
+        };
+        
+        struct QtyNeededField {
+            static char* format(const Record& rec, char* p) {
+                return putInt(p, rec.qtyNeeded);
+            }
+            static bool parse(const char* begin, const char* end, Record& rec) {
+                return parseInt(begin, end, rec.qtyNeeded);
+            }
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                encodeInt(rec.qtyNeeded, out);
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                return decodeInt(data, end, rec.qtyNeeded);
+            }
+            static char* report(const Record& rec, char* p) {
+                p = putRight(p, rec.qtyNeeded, 4);
+                *p++ = '|';
+                return p;
+            }
+            static const char* key() {
+                return "qtyNeeded";
+            }
+            static char* csv(const Record& rec, char* p) {
+                return putInt(p, rec.qtyNeeded);
+            }
+            static char* json(const Record& rec, char* p) {
+                return putInt(p, rec.qtyNeeded);
+            }
+        };
+        
+        // the price after tax, only written by exports
+        struct CostField {
+            static const char* key() {
+                return "cost";
+            }
+            static double cost(const Record& rec) {
+                return rec.taxed ? rec.price * (1 + tax) : rec.price;
+            }
+            static char* csv(const Record& rec, char* p) {
+                return putCents(p, cost(rec));
+            }
+            static char* json(const Record& rec, char* p) {
+                return putJsonNumber(p, cost(rec), putCents);
+            }
+        };
+        
+        struct ExpiryField {
+            
+            // a missing date is written as 0/00/00, as formatRecord() always has
+            static char* format(const Record& rec, char* p) {
+                int year = 0, month = 0, day = 0;
+                if(rec.expiry != 0) {
+                    civilFromDays(rec.expiry, year, month, day);
+                }
+                p = putInt(p, year);
+                *p++ = '/';
+                *p++ = (char)('0' + month / 10);
+                *p++ = (char)('0' + month % 10);
+                *p++ = '/';
+                *p++ = (char)('0' + day / 10);
+                *p++ = (char)('0' + day % 10);
+                return p;
+            }
+            static bool parse(const char* begin, const char* end, Record& rec) {
+                return parseDate(begin, end, rec.expiry);
+            }
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                encodeInt(rec.expiry, out);
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                return decodeInt(data, end, rec.expiry);
+            }
+            static char* report(const Record& rec, char* p) {
+                return format(rec, p);
+            }
+            static const char* key() {
+                return "expiry";
+            }
+            
+            // exports write ISO dates, and an empty field or null for a product without one
+            static char* csv(const Record& rec, char* p) {
+                return rec.expiry == 0 ? p : putIsoDate(p, rec.expiry);
+            }
+            static char* json(const Record& rec, char* p) {
+                if(rec.expiry == 0) {
+                    memcpy(p, "null", 4);
+                    return p + 4;
+                }
+                *p++ = '"';
+                p = putIsoDate(p, rec.expiry);
+                *p++ = '"';
+                return p;
+            }
+        };
+        
+        // splits a line held in memory at its commas
+        class LineCursor {
+            const char* p_;
+            const char* end_;
+            bool more_;
+        public:
+            LineCursor(const char* begin, const char* end) : p_(begin), end_(end), more_(true) {
+            
+            }
+            bool next(const char*& begin, const char*& end) {
+                if(!more_) {
+                    return false;
+                }
+                begin = p_;
+                end = nextComma(p_, end_);
+                more_ = end != end_;
+                p_ = end + 1;
+                return true;
+            }
+            bool done() const {
+                return !more_;
+            }
+        };
+        
+        // splits the line data[begin, end) at comma offsets a scanner already found
+        class IndexCursor {
+            const char* data_;
+            size_t begin_;
+            size_t end_;
+            const uint32_t* commas_;
+            int count_;
+            int field_;
+        public:
+            IndexCursor(const char* data, size_t begin, size_t end, const uint32_t* commas, int count) : data_(data), begin_(begin), end_(end), commas_(commas), count_(count), field_(0) {
+            
+            }
+            bool next(const char*& begin, const char*& end) {
+                if(field_ > count_) {
+                    return false;
+                }
+                begin = data_ + (field_ == 0 ? begin_ : commas_[field_ - 1] + 1);
+                end = data_ + (field_ < count_ ? commas_[field_] : end_);
+                field_++;
+                return true;
+            }
+            bool done() const {
+                return field_ > count_;
+            }
+        };
+        
+        // a list of fields in the order a format holds them
+        template <class... Fields>
+        struct Layout;
+        
+        template <>
+        struct Layout<> {
+            static char* format(const Record&, char* p) {
+                return p;
+            }
+            static char* formatNext(const Record&, char* p) {
+                return p;
+            }
+            template <class Cursor>
+            static bool parse(Cursor&, Record&) {
+                return true;
+            }
+            static void encode(const Record&, std::vector<uint8_t>&) {
+            
+            }
+            static bool decode(const uint8_t*&, const uint8_t*, Record&) {
+                return true;
+            }
+            static char* report(const Record&, char* p) {
+                return p;
+            }
+            static char* csv(const Record&, char* p) {
+                return p;
+            }
+            static char* csvNext(const Record&, char* p) {
+                return p;
+            }
+            static char* json(const Record&, char* p) {
+                return p;
+            }
+            static char* jsonNext(const Record&, char* p) {
+                return p;
+            }
+            static char* header(char* p) {
+                return p;
+            }
+            static char* headerNext(char* p) {
+                return p;
+            }
+        };
+        
+        template <class First, class... Rest>
+        struct Layout<First, Rest...> {
+            
+            typedef Layout<Rest...> Tail;
+            
+            // writes the fields separated by commas
+            static char* format(const Record& rec, char* p) {
+                return Tail::formatNext(rec, First::format(rec, p));
+            }
+            static char* formatNext(const Record& rec, char* p) {
+                *p++ = ',';
+                return format(rec, p);
+            }
+            
+            // takes one field from the cursor for each field of the layout
+            template <class Cursor>
+            static bool parse(Cursor& cursor, Record& rec) {
+                const char* begin;
+                const char* end;
+                return cursor.next(begin, end) && First::parse(begin, end, rec) && Tail::parse(cursor, rec);
+            }
+            
+            static void encode(const Record& rec, std::vector<uint8_t>& out) {
+                First::encode(rec, out);
+                Tail::encode(rec, out);
+            }
+            static bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+                return First::decode(data, end, rec) && Tail::decode(data, end, rec);
+            }
+            
+            static char* report(const Record& rec, char* p) {
+                return Tail::report(rec, First::report(rec, p));
+            }
+            
+            // writes the fields as one CSV row without the line break
+            static char* csv(const Record& rec, char* p) {
+                return Tail::csvNext(rec, First::csv(rec, p));
+            }
+            static char* csvNext(const Record& rec, char* p) {
+                *p++ = ',';
+                return csv(rec, p);
+            }
+            
+            // writes the fields as the members of a JSON object without the braces
+            static char* json(const Record& rec, char* p) {
+                p = putJson(p, First::key());
+                *p++ = ':';
+                return Tail::jsonNext(rec, First::json(rec, p));
+            }
+            static char* jsonNext(const Record& rec, char* p) {
+                *p++ = ',';
+                return json(rec, p);
+            }
+            
+            // writes the field keys as a CSV header row without the line break
+            static char* header(char* p) {
+                return Tail::headerNext(putCsv(p, First::key()));
+            }
+            static char* headerNext(char* p) {
+                *p++ = ',';
+                return header(p);
+            }
+        };
+        
+        // the layouts of each record type, a P record is an N record followed by its expiry date
+        template <char Type>
+        struct RecordSchema {
+            typedef Layout<TypeField, SkuField, NameField, UnitField, TaxedField, PriceField, QtyField, QtyNeededField> Store;
+            typedef Layout<SkuField, NameField, PriceField, QtyField, UnitField, QtyNeededField> Report;
+            typedef Layout<> Extra;
+        };
+        
+        template <>
+        struct RecordSchema<'P'> {
+            typedef RecordSchema<'N'>::Store Store;
+            typedef RecordSchema<'N'>::Report Report;
+            typedef Layout<ExpiryField> Extra;
+        };
+        
+        // the fields written by exports, the same for every record type
+        typedef Layout<TypeField, SkuField, NameField, UnitField, TaxedField, PriceField, CostField, QtyField, QtyNeededField, ExpiryField> Export;
+        
+        // writes the store() fields of record type Type without a new line, returns the end of the line
+        template <char Type>
+        inline char* format(const Record& rec, char* buf) {
+            typedef RecordSchema<Type> S;
+            return S::Extra::formatNext(rec, S::Store::format(rec, buf));
+        }
+        
+        // parses every field of record type Type from cursor, which must hold no more
+        template <char Type, class Cursor>
+        inline bool parse(Cursor& cursor, Record& rec) {
+            typedef RecordSchema<Type> S;
+            return S::Store::parse(cursor, rec) && S::Extra::parse(cursor, rec) && cursor.done();
+        }
+        
+        template <char Type>
+        inline void encode(const Record& rec, std::vector<uint8_t>& out) {
+            RecordSchema<Type>::Store::encode(rec, out);
+            RecordSchema<Type>::Extra::encode(rec, out);
+        }
+        
+        template <char Type>
+        inline bool decode(const uint8_t*& data, const uint8_t* end, Record& rec) {
+            return RecordSchema<Type>::Store::decode(data, end, rec) && RecordSchema<Type>::Extra::decode(data, end, rec);
+        }
+        
+        // writes the report fields of record type Type without a new line, returns the end of the line
+        template <char Type>
+        inline char* report(const Record& rec, char* buf) {
+            typedef RecordSchema<Type> S;
+            return S::Extra::report(rec, S::Report::report(rec, buf));
+        }
+        
+    }
+    
+}
+
+#endif
@@ -0,0 +1,281 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the ShardedInventory class. Each shard keeps a unit table, a CompactInventory and a SkuIndex that only its worker thread touches; callers talk to a shard through its task queue and collect results through futures.
+ ----------------------------------------------- */
+
+#include <limits.h>
+#include <string.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "CompactInventory.h"
+#include "SkuIndex.h"
+#include "UnitTable.h"
+#include "ShardedInventory.h"
+
+namespace AMA {
+    
+    struct ShardedInventory::Shard {
+        
+        UnitTable units;                        // its own table, so adds never contend with other shards
+        CompactInventory inventory;
+        SkuIndex index;
+        
+        std::mutex mutex;                       // guards tasks and closed
+        std::condition_variable ready;
+        std::deque<std::function<void()>> tasks;
+        bool closed;
+        std::thread worker;
+        
+        Shard() : inventory(units), closed(false) {
+            worker = std::thread(&Shard::run, this);
+        }
+        
+        // runs queued tasks in order until the shard is closed and drained
+        void run() {
+            for(;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ready.wait(lock, [this]() {
+                        return !tasks.empty() || closed;
+                    });
+                    if(tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+        
+        void push(std::function<void()> task) {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+            ready.notify_one();
+        }
+        
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+                ready.notify_one();
+            }
+            worker.join();
+        }
+        
+        // adds delta to the quantity of sku, returns false if sku is not in the shard
+        bool adjust(const char* sku, int delta) {
+            int i = index.find(sku);
+            if(i < 0) {
+                return false;
+            }
+            inventory.quantity(i, inventory.hot(i).qty + delta);
+            return true;
+        }
+        
+    };
+    
+    // starts the shards and their worker threads
+    ShardedInventory::ShardedInventory(int shards) {
+        if(shards <= 0) {
+            shards = (int)std::thread::hardware_concurrency();
+        }
+        if(shards <= 0) {
+            shards = 1;
+        }
+        for(int i = 0; i < shards; i++) {
+            shards_.push_back(std::unique_ptr<Shard>(new Shard()));
+        }
+    }
+    
+    // finishes queued requests and stops the worker threads
+    ShardedInventory::~ShardedInventory() {
+        for(size_t i = 0; i < shards_.size(); i++) {
+            shards_[i]->close();
+        }
+    }
+    
+    void ShardedInventory::submit(int shard, std::function<void()> task) {
+        shards_[shard]->push(std::move(task));
+    }
+    
+    // runs task on every shard's own thread and waits until all have finished
+    void ShardedInventory::broadcast(const std::function<void(int, CompactInventory&)>& task) {
+        std::vector<std::future<void>> done;
+        for(size_t i = 0; i < shards_.size(); i++) {
+            auto promise = std::make_shared<std::promise<void>>();
+            done.push_back(promise->get_future());
+            Shard* shard = shards_[i].get();
+            int n = (int)i;
+            submit(n, [promise, shard, n, &task]() {
+                task(n, shard->inventory);
+                promise->set_value();
+            });
+        }
+        for(size_t i = 0; i < done.size(); i++) {
+            done[i].get();
+        }
+    }
+    
+    // distributes products to the shards that own their skus
+    void ShardedInventory::build(const iProduct* const* products, int count) {
+        
+        std::vector<std::vector<Record>> parts(shards_.size());
+        Record rec;
+        for(int i = 0; i < count; i++) {
+            if(products[i] != nullptr && toRecord(*products[i], rec)) {
+                parts[shardOf(rec.sku)].push_back(rec);
+            }
+        }
+        
+        broadcast([&](int n, CompactInventory& inventory) {
+            Shard& shard = *shards_[n];
+            inventory.clear();
+            shard.index.clear();
+            const std::vector<Record>& part = parts[n];
+            for(size_t i = 0; i < part.size(); i++) {
+                int at = inventory.add(part[i]);
+                if(at >= 0) {
+                    shard.index.insert(part[i].sku, at);
+                }
+            }
+        });
+    }
+    
+    int ShardedInventory::shards() const {
+        return (int)shards_.size();
+    }
+    
+    // returns the shard that owns sku
+    int ShardedInventory::shardOf(const char* sku) const {
+        uint64_t key = SkuIndex::pack(sku) * 0x9E3779B97F4A7C15ULL;
+        return (int)((key >> 32) % shards_.size());
+    }
+    
+    // returns the number of products in every shard
+    int ShardedInventory::size() {
+        std::vector<int> sizes(shards_.size());
+        broadcast([&](int n, CompactInventory& inventory) {
+            sizes[n] = inventory.size();
+        });
+        int total = 0;
+        for(size_t i = 0; i < sizes.size(); i++) {
+            total += sizes[i];
+        }
+        return total;
+    }
+    
+    // queues a lookup of sku on its shard
+    std::future<Record> ShardedInventory::lookup(const char* sku) {
+        auto promise = std::make_shared<std::promise<Record>>();
+        std::future<Record> result = promise->get_future();
+        int n = shardOf(sku);
+        Shard* shard = shards_[n].get();
+        char key[max_sku_length + 1];
+        strncpy(key, sku, max_sku_length);
+        key[max_sku_length] = '\0';
+        submit(n, [promise, shard, key]() {
+            Record rec;
+            clear(rec);
+            int i = shard->index.find(key);
+            if(i >= 0) {
+                shard->inventory.record(i, rec);
+            }
+            promise->set_value(rec);
+        });
+        return result;
+    }
+    
+    // queues an adjustment of the quantity of sku on its shard
+    std::future<bool> ShardedInventory::adjust(const char* sku, int delta) {
+        auto promise = std::make_shared<std::promise<bool>>();
+        std::future<bool> result = promise->get_future();
+        int n = shardOf(sku);
+        Shard* shard = shards_[n].get();
+        Adjustment change;
+        strncpy(change.sku, sku, max_sku_length);
+        change.sku[max_sku_length] = '\0';
+        change.delta = delta;
+        submit(n, [promise, shard, change]() {
+            promise->set_value(shard->adjust(change.sku, change.delta));
+        });
+        return result;
+    }
+    
+    // splits changes by shard and applies each part on its shard's thread
+    int ShardedInventory::adjust(const std::vector<Adjustment>& changes) {
+        
+        std::vector<std::vector<const Adjustment*>> parts(shards_.size());
+        for(size_t i = 0; i < changes.size(); i++) {
+            parts[shardOf(changes[i].sku)].push_back(&changes[i]);
+        }
+        
+        std::vector<int> found(shards_.size());
+        broadcast([&](int n, CompactInventory&) {
+            Shard& shard = *shards_[n];
+            const std::vector<const Adjustment*>& part = parts[n];
+            int count = 0;
+            for(size_t i = 0; i < part.size(); i++) {
+                if(shard.adjust(part[i]->sku, part[i]->delta)) {
+                    count++;
+                }
+            }
+            found[n] = count;
+        });
+        
+        int total = 0;
+        for(size_t i = 0; i < found.size(); i++) {
+            total += found[i];
+        }
+        return total;
+    }
+    
+    // returns the total cost of the inventory
+    double ShardedInventory::valuation() {
+        std::vector<double> totals(shards_.size());
+        broadcast([&](int n, CompactInventory& inventory) {
+            totals[n] = inventory.valuation();
+        });
+        double total = 0.0;
+        for(size_t i = 0; i < totals.size(); i++) {
+            total += totals[i];
+        }
+        return total;
+    }
+    
+    // returns the number of products with less on hand than needed
+    int ShardedInventory::shortfall() {
+        std::vector<int> counts(shards_.size());
+        broadcast([&](int n, CompactInventory& inventory) {
+            counts[n] = inventory.shortfall();
+        });
+        int total = 0;
+        for(size_t i = 0; i < counts.size(); i++) {
+            total += counts[i];
+        }
+        return total;
+    }
+    
+    // appends to found the perishables that expire between from and to inclusive, an empty date leaves that end open
+    void ShardedInventory::expiring(const Date& from, const Date& to, std::vector<Record>& found) {
+        int first = from.dayNumber() != 0 ? from.dayNumber() : INT_MIN;
+        int last = to.dayNumber() != 0 ? to.dayNumber() : INT_MAX;
+        std::vector<std::vector<Record>> parts(shards_.size());
+        broadcast([&](int n, CompactInventory& inventory) {
+            for(int i = 0; i < inventory.size(); i++) {
+                int expiry = inventory.hot(i).expiry;
+                if(expiry != 0 && expiry >= first && expiry <= last) {
+                    Record rec;
+                    inventory.record(i, rec);
+                    parts[n].push_back(rec);
+                }
+            }
+        });
+        for(size_t i = 0; i < parts.size(); i++) {
+            found.insert(found.end(), parts[i].begin(), parts[i].end());
+        }
+    }
+    
+}
@@ -0,0 +1,68 @@
+/* --------------------------------------------
+ Description: This is the header file for ShardedInventory.cpp. It declares the ShardedInventory class which partitions products by a hash of their sku into shards, each owning its storage and a worker thread that serves the requests queued for it, so no product is ever shared between threads.
+ ----------------------------------------------- */
+
+#ifndef AMA_SHARDEDINVENTORY_H_
+#define AMA_SHARDEDINVENTORY_H_
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+#include "Date.h"
+#include "Record.h"
+
+namespace AMA {
+    
+    class CompactInventory;
+    class SkuIndex;
+    
+    struct Adjustment {
+        char sku[max_sku_length + 1];
+        int delta;
+    };
+    
+    class ShardedInventory {
+        
+        struct Shard;
+        std::vector<std::unique_ptr<Shard>> shards_;
+        
+        void submit(int shard, std::function<void()> task);
+        
+        // runs task on every shard and waits for all of them
+        void broadcast(const std::function<void(int, CompactInventory&)>& task);
+        
+    public:
+        // shards 0 starts one shard per hardware thread
+        explicit ShardedInventory(int shards = 0);
+        ShardedInventory(const ShardedInventory&) = delete;
+        ShardedInventory& operator=(const ShardedInventory&) = delete;
+        ~ShardedInventory();
+        
+        // replaces the inventory, each shard copies its own products on its own thread
+        void build(const iProduct* const* products, int count);
+        
+        int shards() const;
+        int shardOf(const char* sku) const;
+        int size();
+        
+        // single requests, queued on the shard that owns sku
+        // lookup yields an empty record and adjust yields false when sku is not in the inventory
+        std::future<Record> lookup(const char* sku);
+        std::future<bool> adjust(const char* sku, int delta);
+        
+        // queues one request per shard for the whole batch, returns the number of skus found
+        int adjust(const std::vector<Adjustment>& changes);
+        
+        // aggregates computed by every shard in parallel and combined in shard order
+        double valuation();
+        int shortfall();
+        
+        // perishables expiring between from and to inclusive, an empty Date leaves that end open as in Query
+        void expiring(const Date& from, const Date& to, std::vector<Record>& found);
+        
+    };
+    
+}
+
+#endif
@@ -0,0 +1,123 @@
+/* --------------------------------------------
+ Description: This implementation file contains the definitions for the SharedInventory class. Products are copied through Record, so an update works on a private copy and the published product is never written to again.
+ ----------------------------------------------- */
+
+#include "SharedInventory.h"
+
+namespace AMA {
+    
+    namespace {
+        
+        void destroyProduct(void* ptr) {
+            delete static_cast<iProduct*>(ptr);
+        }
+        
+    }
+    
+    // sets inventory to safe empty state
+    SharedInventory::SharedInventory() : size_(0) {
+        
+    }
+    
+    // deletes every published product, retired ones are freed by the epoch domain
+    SharedInventory::~SharedInventory() {
+        for(int i = 0; i < size_; i++) {
+            delete products_[i].load(std::memory_order_relaxed);
+        }
+    }
+    
+    // replaces the inventory with copies of products
+    void SharedInventory::build(const iProduct* const* products, int count) {
+        
+        for(int i = 0; i < size_; i++) {
+            delete products_[i].load(std::memory_order_relaxed);
+        }
+        
+        products_.reset(new std::atomic<iProduct*>[count]);
+        size_ = count;
+        
+        // a null product or one not derived from Product leaves an empty slot, which the index skips too
+        Record rec;
+        for(int i = 0; i < count; i++) {
+            bool copied = products[i] != nullptr && toRecord(*products[i], rec);
+            products_[i].store(copied ? createFromRecord(rec) : nullptr, std::memory_order_relaxed);
+        }
+        
+        index_.build(products, count);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    
+    int SharedInventory::size() const {
+        return size_;
+    }
+    
+    // returns the position of sku, -1 if it is not in the inventory
+    int SharedInventory::find(const char* sku) const {
+        return index_.find(sku);
+    }
+    
+    EpochDomain& SharedInventory::domain() const {
+        return epochs_;
+    }
+    
+    // returns product i, valid while guard is pinned
+    const iProduct* SharedInventory::get(const EpochGuard&, int i) const {
+        if(i < 0 || i >= size_) {
+            return nullptr;
+        }
+        return products_[i].load(std::memory_order_acquire);
+    }
+    
+    // calls visit with product i while pinned
+    bool SharedInventory::read(int i, const std::function<void(const iProduct&)>& visit) const {
+        EpochGuard guard(epochs_);
+        const iProduct* prd = get(guard, i);
+        if(prd == nullptr) {
+            return false;
+        }
+        visit(*prd);
+        return true;
+    }
+    
+    // swaps prd into position i and retires the product it replaces, caller holds writer_
+    void SharedInventory::publish(int i, iProduct* prd) {
+        iProduct* old = products_[i].exchange(prd, std::memory_order_seq_cst);
+        if(old != nullptr) {
+            epochs_.retire(old, destroyProduct);
+        }
+    }
+    
+    // replaces product i with a product built from rec
+    bool SharedInventory::replace(int i, const Record& rec) {
+        if(i < 0 || i >= size_) {
+            return false;
+        }
+        iProduct* prd = createFromRecord(rec);
+        std::lock_guard<std::mutex> lock(writer_);
+        publish(i, prd);
+        return true;
+    }
+    
+    // applies change to a copy of product i and publishes the copy
+    bool SharedInventory::update(int i, const std::function<void(iProduct&)>& change) {
+        if(i < 0 || i >= size_) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(writer_);
+        Record rec;
+        const iProduct* current = products_[i].load(std::memory_order_relaxed);
+        if(current == nullptr || !toRecord(*current, rec)) {
+            return false;
+        }
+        iProduct* prd = createFromRecord(rec);
+        change(*prd);
+        publish(i, prd);
+        return true;
+    }
+    
+    // returns the number of replaced products waiting for readers to unpin
+    size_t SharedInventory::retired() const {
+        return epochs_.collect();
+    }
+    
+}
@@ -0,0 +1,59 @@
+/* --------------------------------------------
+ Description: This is the header file for SharedInventory.cpp. It declares the SharedInventory class which lets reporting threads read products without locks while an update thread replaces them: a writer never changes a published product, it publishes a changed copy and retires the old one through an EpochDomain.
+ ----------------------------------------------- */
+
+#ifndef AMA_SHAREDINVENTORY_H_
+#define AMA_SHAREDINVENTORY_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "Epoch.h"
+#include "Record.h"
+#include "SkuIndex.h"
+
+namespace AMA {
+    
+    class SharedInventory {
+        
+        std::unique_ptr<std::atomic<iProduct*>[]> products_;
+        int size_;
+        SkuIndex index_;                        // position of each sku, fixed after build()
+        mutable EpochDomain epochs_;
+        std::mutex writer_;                     // writers are serialised, readers never take it
+        
+        void publish(int i, iProduct* prd);
+        
+    public:
+        SharedInventory();
+        SharedInventory(const SharedInventory&) = delete;
+        SharedInventory& operator=(const SharedInventory&) = delete;
+        ~SharedInventory();
+        
+        // copies count products, no reader or writer may use the inventory during build()
+        // the position of a null product or one not derived from Product stays empty, get() returns nullptr for it
+        void build(const iProduct* const* products, int count);
+        
+        int size() const;
+        int find(const char* sku) const;
+        
+        // readers pin an EpochGuard on domain() and may use what get() returns until the guard ends
+        EpochDomain& domain() const;
+        const iProduct* get(const EpochGuard& guard, int i) const;
+        
+        // pins, calls visit with product i and unpins, returns false if i is out of range
+        bool read(int i, const std::function<void(const iProduct&)>& visit) const;
+        
+        // writers, each publishes a new product and retires the one it replaces, update() fails on an empty position
+        bool replace(int i, const Record& rec);
+        bool update(int i, const std::function<void(iProduct&)>& change);
+        
+        // number of replaced products not yet freed
+        size_t retired() const;
+        
+    };
+    
+}
+
+#endif
@@ -0,0 +1,172 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the SkuIndex class. Keys live in one sorted array plus a small sorted array of recent inserts, and scans walk both arrays together so the index never has to be rebuilt for a single insert.
+ ----------------------------------------------- */
+
+#include <algorithm>
+#include <string.h>
+#include <thread>
+#include "Product.h"
+#include "SkuIndex.h"
+#include "Latency.h"
+
+namespace AMA {
+    
+    // orders entries by key, then by value so equal skus keep inventory order
+    static bool lessEntry(const SkuEntry& a, const SkuEntry& b) {
+        return a.key < b.key || (a.key == b.key && a.value < b.value);
+    }
+    
+    // packs up to 8 characters of sku big-endian, so integer order matches strcmp order
+    uint64_t SkuIndex::pack(const char* sku) {
+        uint64_t key = 0;
+        int i = 0;
+        for(; i < 8 && sku[i] != '\0'; i++) {
+            key = (key << 8) | (unsigned char)sku[i];
+        }
+        return i == 0 ? 0 : key << (8 * (8 - i));
+    }
+    
+    // unpacks key into sku, which must hold max_sku_length + 2 characters
+    void SkuIndex::unpack(uint64_t key, char* sku) {
+        for(int i = 0; i < 8; i++) {
+            sku[i] = (char)(key >> (56 - 8 * i));
+        }
+        sku[8] = '\0';
+    }
+    
+    // replaces the index with the skus of products, sorting pieces of the array on separate threads
+    void SkuIndex::build(const iProduct* const* products, int count, int threads) {
+        
+        sorted_.clear();
+        pending_.clear();
+        sorted_.reserve(count > 0 ? count : 0);
+        
+        for(int i = 0; i < count; i++) {
+            const Product* prd = dynamic_cast<const Product*>(products[i]);
+            if(prd != nullptr) {
+                SkuEntry ent = { pack(prd->sku()), i };
+                sorted_.push_back(ent);
+            }
+        }
+        
+        if(threads <= 0) {
+            threads = (int)std::thread::hardware_concurrency();
+        }
+        if(threads <= 0 || sorted_.size() < 65536) {
+            threads = 1;
+        }
+        
+        // sorts one piece per thread, then merges neighbouring pieces until one is left
+        std::vector<size_t> bounds;
+        for(int t = 0; t <= threads; t++) {
+            bounds.push_back(sorted_.size() * t / threads);
+        }
+        
+        std::vector<std::thread> pool;
+        for(int t = 1; t < threads; t++) {
+            pool.emplace_back([this, &bounds, t]() {
+                std::sort(sorted_.begin() + bounds[t], sorted_.begin() + bounds[t + 1], lessEntry);
+            });
+        }
+        std::sort(sorted_.begin() + bounds[0], sorted_.begin() + bounds[1], lessEntry);
+        for(auto& th : pool) {
+            th.join();
+        }
+        
+        for(size_t width = 1; width < (size_t)threads; width *= 2) {
+            pool.clear();
+            for(size_t t = 0; t + width < (size_t)threads; t += 2 * width) {
+                size_t last = t + 2 * width < (size_t)threads ? t + 2 * width : threads;
+                pool.emplace_back([this, &bounds, t, width, last]() {
+                    std::inplace_merge(sorted_.begin() + bounds[t], sorted_.begin() + bounds[t + width], sorted_.begin() + bounds[last], lessEntry);
+                });
+            }
+            for(auto& th : pool) {
+                th.join();
+            }
+        }
+    }
+    
+    // adds sku for the product at position value
+    void SkuIndex::insert(const char* sku, int value) {
+        SkuEntry ent = { pack(sku), value };
+        pending_.insert(std::upper_bound(pending_.begin(), pending_.end(), ent, lessEntry), ent);
+        if(pending_.size() >= pending_limit) {
+            merge();
+        }
+    }
+    
+    // moves the recent inserts into the main array
+    void SkuIndex::merge() {
+        size_t middle = sorted_.size();
+        sorted_.insert(sorted_.end(), pending_.begin(), pending_.end());
+        std::inplace_merge(sorted_.begin(), sorted_.begin() + middle, sorted_.end(), lessEntry);
+        pending_.clear();
+    }
+    
+    // removes every entry
+    void SkuIndex::clear() {
+        sorted_.clear();
+        pending_.clear();
+    }
+    
+    // returns the number of entries
+    size_t SkuIndex::size() const {
+        return sorted_.size() + pending_.size();
+    }
+    
+    // returns the number of bytes allocated by the index
+    size_t SkuIndex::memoryUsage() const {
+        return (sorted_.capacity() + pending_.capacity()) * sizeof(SkuEntry);
+    }
+    
+    // returns the value stored for sku, -1 if not found
+    int SkuIndex::find(const char* sku) const {
+        LatencyTimer timer(latency_lookup);
+        SkuEntry key = { pack(sku), -1 };
+        auto it = std::upper_bound(sorted_.begin(), sorted_.end(), key, lessEntry);
+        if(it != sorted_.end() && it->key == key.key) {
+            return it->value;
+        }
+        it = std::upper_bound(pending_.begin(), pending_.end(), key, lessEntry);
+        if(it != pending_.end() && it->key == key.key) {
+            return it->value;
+        }
+        return -1;
+    }
+    
+    // walks both arrays in key order over keys [lo, hi]
+    static void scanKeys(const std::vector<SkuEntry>& a, const std::vector<SkuEntry>& b, uint64_t lo, uint64_t hi, const std::function<bool(const SkuEntry&)>& visit) {
+        
+        SkuEntry first = { lo, -1 };
+        auto i = std::upper_bound(a.begin(), a.end(), first, lessEntry);
+        auto j = std::upper_bound(b.begin(), b.end(), first, lessEntry);
+        
+        for(;;) {
+            bool useA = i != a.end() && i->key <= hi;
+            bool useB = j != b.end() && j->key <= hi;
+            if(useA && useB) {
+                useA = !lessEntry(*j, *i);
+            } else if(!useA && !useB) {
+                return;
+            }
+            if(!visit(useA ? *i++ : *j++)) {
+                return;
+            }
+        }
+    }
+    
+    // visits the entries with sku in [from, to]
+    void SkuIndex::range(const char* from, const char* to, const std::function<bool(const SkuEntry&)>& visit) const {
+        scanKeys(sorted_, pending_, pack(from), pack(to), visit);
+    }
+    
+    // visits the entries whose sku starts with prefix
+    void SkuIndex::prefix(const char* prefix, const std::function<bool(const SkuEntry&)>& visit) const {
+        size_t length = strlen(prefix) < 8 ? strlen(prefix) : 8;
+        uint64_t lo = pack(prefix);
+        uint64_t hi = length == 0 ? ~uint64_t(0) : lo | (~uint64_t(0) >> (8 * length));
+        scanKeys(sorted_, pending_, lo, hi, visit);
+    }
+    
+}
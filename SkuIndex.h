@@ -0,0 +1,53 @@
+/* --------------------------------------------
+ Description: This is the header file for SkuIndex.cpp. It declares the SkuIndex class, a sorted index of skus for range and prefix scans. Each sku is packed into a 64-bit key whose integer order is the same as the strcmp order used by Product::operator>.
+ ----------------------------------------------- */
+
+#ifndef AMA_SKUINDEX_H_
+#define AMA_SKUINDEX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <vector>
+#include "iProduct.h"
+
+namespace AMA {
+    
+    struct SkuEntry {
+        uint64_t key;                           // sku packed by SkuIndex::pack()
+        int value;                              // position of the product in the inventory
+    };
+    
+    class SkuIndex {
+        
+        std::vector<SkuEntry> sorted_;
+        std::vector<SkuEntry> pending_;         // recent inserts, sorted, merged into sorted_ when full
+        
+        void merge();
+        
+    public:
+        
+        // largest number of inserts kept apart from the main array
+        static const size_t pending_limit = 4096;
+        
+        static uint64_t pack(const char* sku);
+        static void unpack(uint64_t key, char* sku);
+        
+        void build(const iProduct* const* products, int count, int threads = 0);
+        void insert(const char* sku, int value);
+        void clear();
+        
+        size_t size() const;
+        size_t memoryUsage() const;
+        
+        int find(const char* sku) const;
+        
+        // visits entries in sku order, visit returns false to stop
+        void range(const char* from, const char* to, const std::function<bool(const SkuEntry&)>& visit) const;
+        void prefix(const char* prefix, const std::function<bool(const SkuEntry&)>& visit) const;
+        
+    };
+    
+}
+
+#endif
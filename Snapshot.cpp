@@ -0,0 +1,316 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the Snapshot class. An image is written with a single pass over the inventory and read back with mmap, so opening it costs only the pages that are actually touched.
+ ----------------------------------------------- */
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Snapshot.h"
+
+namespace AMA {
+    
+    static const char snapshot_magic[8] = { 'A', 'M', 'A', 'S', 'N', 'A', 'P', '1' };
+    static const uint32_t snapshot_version = 1;
+    
+    // rounds offset up to the next multiple of 8
+    static uint64_t align8(uint64_t offset) {
+        return (offset + 7) & ~uint64_t(7);
+    }
+    
+    // writes size bytes of data to fd, retrying short writes
+    static bool writeAll(int fd, const char* data, size_t size) {
+        while(size > 0) {
+            ssize_t written = ::write(fd, data, size);
+            if(written < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+    
+    // returns the header at the start of the mapped image
+    const SnapshotHeader& Snapshot::header() const {
+        return *reinterpret_cast<const SnapshotHeader*>(base_);
+    }
+    
+    // sets object to safe empty state
+    Snapshot::Snapshot() {
+        fd_ = -1;
+        base_ = nullptr;
+        size_ = 0;
+    }
+    
+    // unmaps any image that is still open
+    Snapshot::~Snapshot() {
+        close();
+    }
+    
+    // writes the products as one image to path
+    // products that are not derived from Product are skipped
+    bool Snapshot::save(const char* path, const iProduct* const* products, int count) {
+        
+        error_.clear();
+        
+        std::vector<SnapshotEntry> entries;
+        std::string pool;
+        std::map<std::string, uint32_t> units;
+        Record rec;
+        
+        entries.reserve(count > 0 ? count : 0);
+        
+        for(int i = 0; i < count; i++) {
+            
+            if(products[i] == nullptr || !toRecord(*products[i], rec)) {
+                continue;
+            }
+            
+            SnapshotEntry ent;
+            memset(&ent, 0, sizeof(ent));
+            
+            ent.price = rec.price;
+            ent.qty = rec.qty;
+            ent.qtyNeeded = rec.qtyNeeded;
+            ent.expiry = rec.expiry;
+            memcpy(ent.sku, rec.sku, sizeof(ent.sku));
+            memcpy(ent.name, rec.name, sizeof(ent.name));
+            ent.type = rec.type;
+            ent.taxed = rec.taxed;
+            
+            // each distinct unit is stored once in the pool
+            std::map<std::string, uint32_t>::iterator it = units.find(rec.unit);
+            if(it == units.end()) {
+                it = units.insert(std::make_pair(std::string(rec.unit), (uint32_t)pool.size())).first;
+                pool.append(rec.unit);
+                pool.push_back('\0');
+            }
+            ent.unit = it->second;
+            
+            entries.push_back(ent);
+        }
+        
+        // sku index holds entry numbers in strcmp order of sku
+        std::vector<uint32_t> index(entries.size());
+        for(size_t i = 0; i < index.size(); i++) {
+            index[i] = (uint32_t)i;
+        }
+        std::sort(index.begin(), index.end(), [&](uint32_t a, uint32_t b) {
+            return strcmp(entries[a].sku, entries[b].sku) < 0;
+        });
+        
+        SnapshotHeader hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, snapshot_magic, sizeof(hdr.magic));
+        hdr.version = snapshot_version;
+        hdr.count = (uint32_t)entries.size();
+        hdr.entries = align8(sizeof(hdr));
+        hdr.index = align8(hdr.entries + entries.size() * sizeof(SnapshotEntry));
+        hdr.pool = align8(hdr.index + index.size() * sizeof(uint32_t));
+        hdr.size = hdr.pool + pool.size();
+        
+        std::vector<char> image(hdr.size, '\0');
+        memcpy(&image[0], &hdr, sizeof(hdr));
+        if(!entries.empty()) {
+            memcpy(&image[hdr.entries], &entries[0], entries.size() * sizeof(SnapshotEntry));
+            memcpy(&image[hdr.index], &index[0], index.size() * sizeof(uint32_t));
+        }
+        if(!pool.empty()) {
+            memcpy(&image[hdr.pool], pool.data(), pool.size());
+        }
+        
+        // the image is written beside path and renamed over it, so a Snapshot that still maps
+        // the old file keeps its pages and a reader never sees a partly written image
+        std::string temp = std::string(path) + ".tmp";
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        
+        if(fd < 0) {
+            error_.message("Unable to write snapshot file");
+            return false;
+        }
+        
+        bool ok = writeAll(fd, &image[0], image.size()) && fsync(fd) == 0;
+        
+        if(::close(fd) != 0) {
+            ok = false;
+        }
+        
+        if(!ok || rename(temp.c_str(), path) != 0) {
+            unlink(temp.c_str());
+            error_.message("Unable to write snapshot file");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // maps the image stored at path into memory
+    // returns false and sets message if the file is not a valid image
+    bool Snapshot::open(const char* path) {
+        
+        close();
+        error_.clear();
+        
+        fd_ = ::open(path, O_RDONLY);
+        
+        if(fd_ < 0) {
+            error_.message("Unable to open snapshot file");
+            return false;
+        }
+        
+        struct stat st;
+        
+        if(fstat(fd_, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+            error_.message("Snapshot file is too short");
+            close();
+            return false;
+        }
+        
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd_, 0);
+        
+        if(addr == MAP_FAILED) {
+            error_.message("Unable to map snapshot file");
+            close();
+            return false;
+        }
+        
+        base_ = static_cast<const char*>(addr);
+        size_ = st.st_size;
+        
+        const SnapshotHeader& hdr = header();
+        
+        if(memcmp(hdr.magic, snapshot_magic, sizeof(hdr.magic)) != 0 || hdr.version != snapshot_version) {
+            error_.message("Not a snapshot file");
+            close();
+            return false;
+        }
+        
+        if(hdr.size != size_ ||
+           hdr.entries + (uint64_t)hdr.count * sizeof(SnapshotEntry) > hdr.index ||
+           hdr.index + (uint64_t)hdr.count * sizeof(uint32_t) > hdr.pool ||
+           hdr.pool > hdr.size) {
+            error_.message("Snapshot file is corrupt");
+            close();
+            return false;
+        }
+        
+        // a pool ending in a null keeps every unit string inside it, and the index may only name entries
+        bool valid = hdr.pool == hdr.size || base_[hdr.size - 1] == '\0';
+        const uint32_t* index = reinterpret_cast<const uint32_t*>(base_ + hdr.index);
+        for(uint32_t i = 0; i < hdr.count && valid; i++) {
+            valid = index[i] < hdr.count;
+        }
+        
+        if(!valid) {
+            error_.message("Snapshot file is corrupt");
+            close();
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // unmaps the image and returns to safe empty state
+    void Snapshot::close() {
+        if(base_ != nullptr) {
+            munmap(const_cast<char*>(base_), size_);
+        }
+        if(fd_ >= 0) {
+            ::close(fd_);
+        }
+        fd_ = -1;
+        base_ = nullptr;
+        size_ = 0;
+    }
+    
+    // returns true if an image is mapped
+    bool Snapshot::isOpen() const {
+        return base_ != nullptr;
+    }
+    
+    // returns the last error message, nullptr if there was none
+    const char* Snapshot::message() const {
+        return error_.message();
+    }
+    
+    // returns number of entries in the image
+    int Snapshot::size() const {
+        return isOpen() ? (int)header().count : 0;
+    }
+    
+    // returns entry i directly from the mapped image
+    const SnapshotEntry& Snapshot::entry(int i) const {
+        return reinterpret_cast<const SnapshotEntry*>(base_ + header().entries)[i];
+    }
+    
+    // returns the unit string of an entry from the pool
+    const char* Snapshot::unit(const SnapshotEntry& ent) const {
+        const SnapshotHeader& hdr = header();
+        return ent.unit < hdr.size - hdr.pool ? base_ + hdr.pool + ent.unit : "";
+    }
+    
+    // returns the entry number with the sku received, -1 if not found
+    int Snapshot::find(const char* sku) const {
+        
+        if(!isOpen()) {
+            return -1;
+        }
+        
+        const uint32_t* index = reinterpret_cast<const uint32_t*>(base_ + header().index);
+        int lo = 0;
+        int hi = size();
+        
+        // binary search over the sku index
+        while(lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            int cmp = strncmp(entry(index[mid]).sku, sku, max_sku_length + 1);
+            if(cmp == 0) {
+                return index[mid];
+            } else if(cmp < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        
+        return -1;
+    }
+    
+    // copies entry i into rec
+    void Snapshot::record(int i, Record& rec) const {
+        
+        const SnapshotEntry& ent = entry(i);
+        
+        clear(rec);
+        rec.type = ent.type;
+        memcpy(rec.sku, ent.sku, sizeof(rec.sku));
+        memcpy(rec.name, ent.name, sizeof(rec.name));
+        rec.sku[max_sku_length] = '\0';
+        rec.name[max_name_length] = '\0';
+        strncpy(rec.unit, unit(ent), max_unit_length);
+        rec.taxed = ent.taxed != 0;
+        rec.price = ent.price;
+        rec.qty = ent.qty;
+        rec.qtyNeeded = ent.qtyNeeded;
+        rec.expiry = ent.expiry;
+    }
+    
+    // returns the address of a new Product or Perishable for entry i
+    iProduct* Snapshot::restore(int i) const {
+        Record rec;
+        record(i, rec);
+        return createFromRecord(rec);
+    }
+    
+}
@@ -0,0 +1,75 @@
+/* --------------------------------------------
+ Description: This is the header file for Snapshot.cpp. It declares the Snapshot class which saves a loaded inventory as one contiguous image and maps it back into memory, so a restart does not have to parse the text file again.
+ ----------------------------------------------- */
+
+#ifndef AMA_SNAPSHOT_H_
+#define AMA_SNAPSHOT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ErrorState.h"
+#include "Record.h"
+
+namespace AMA {
+    
+    // layout of the image: header, entries, sku index, unit pool
+    // every reference inside the image is an offset from its start, so the image can be mapped at any address
+    struct SnapshotHeader {
+        char magic[8];                          // "AMASNAP1"
+        uint32_t version;
+        uint32_t count;                         // number of entries
+        uint64_t entries;                       // offset of the first SnapshotEntry
+        uint64_t index;                         // offset of count entry numbers sorted by sku
+        uint64_t pool;                          // offset of the null terminated unit strings
+        uint64_t size;                          // size of the whole image
+    };
+    
+    struct SnapshotEntry {
+        double price;
+        int32_t qty;
+        int32_t qtyNeeded;
+        int32_t expiry;                         // Date::dayNumber() of expiry date, 0 if none
+        uint32_t unit;                          // offset of the unit string within the pool
+        char sku[max_sku_length + 1];
+        char name[max_name_length + 1];
+        char type;
+        char taxed;
+        char reserved[3];
+    };
+    
+    class Snapshot {
+        
+        int fd_;
+        const char* base_;
+        size_t size_;
+        ErrorState error_;
+        
+        const SnapshotHeader& header() const;
+        
+    public:
+        Snapshot();
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        ~Snapshot();
+        
+        // save() replaces path with a complete image through a rename, so images already open stay intact
+        bool save(const char* path, const iProduct* const* products, int count);
+        bool open(const char* path);
+        void close();
+        
+        bool isOpen() const;
+        const char* message() const;
+        
+        int size() const;
+        const SnapshotEntry& entry(int i) const;
+        const char* unit(const SnapshotEntry& ent) const;
+        int find(const char* sku) const;
+        
+        void record(int i, Record& rec) const;
+        iProduct* restore(int i) const;
+        
+    };
+    
+}
+
+#endif
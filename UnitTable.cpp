@@ -0,0 +1,92 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the UnitTable class. Adding a unit takes a lock, but looking up the text of an id never does: ids index a two level table whose chunks are published with release stores once they are filled in.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include "Product.h"
+#include "UnitTable.h"
+
+namespace AMA {
+    
+    // creates a table holding only the empty unit
+    UnitTable::UnitTable() {
+        for(int i = 0; i < max_units / chunk_size; i++) {
+            chunks_[i].store(nullptr, std::memory_order_relaxed);
+        }
+        size_.store(0, std::memory_order_relaxed);
+        intern("");
+    }
+    
+    // frees the chunks of the id table
+    UnitTable::~UnitTable() {
+        for(int i = 0; i < max_units / chunk_size; i++) {
+            delete [] chunks_[i].load(std::memory_order_relaxed);
+        }
+    }
+    
+    // returns the id of unit, adding it if it is new
+    uint16_t UnitTable::intern(const char* unit) {
+        
+        std::string key(unit, strnlen(unit, max_unit_length));
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        std::unordered_map<std::string, uint16_t>::iterator it = ids_.find(key);
+        
+        if(it != ids_.end()) {
+            return it->second;
+        }
+        
+        int id = size_.load(std::memory_order_relaxed);
+        
+        if(id >= no_unit) {
+            return no_unit;
+        }
+        
+        text_.push_back(key);
+        
+        const char** chunk = chunks_[id / chunk_size].load(std::memory_order_relaxed);
+        if(chunk == nullptr) {
+            chunk = new const char* [chunk_size];
+            chunks_[id / chunk_size].store(chunk, std::memory_order_release);
+        }
+        chunk[id % chunk_size] = text_.back().c_str();
+        
+        ids_[key] = (uint16_t)id;
+        size_.store(id + 1, std::memory_order_release);
+        
+        return (uint16_t)id;
+    }
+    
+    // returns the text of id without locking
+    const char* UnitTable::name(uint16_t id) const {
+        if(id >= size_.load(std::memory_order_acquire)) {
+            return "";
+        }
+        return chunks_[id / chunk_size].load(std::memory_order_acquire)[id % chunk_size];
+    }
+    
+    // returns the number of distinct units
+    int UnitTable::size() const {
+        return size_.load(std::memory_order_acquire);
+    }
+    
+    // returns an estimate of the bytes allocated by the table
+    size_t UnitTable::memoryUsage() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int count = size();
+        // one string and one hash node per unit, plus the chunks in use
+        size_t bytes = (count + chunk_size - 1) / chunk_size * chunk_size * sizeof(const char*);
+        bytes += count * (2 * sizeof(std::string) + sizeof(uint16_t) + 2 * sizeof(void*));
+        for(size_t i = 0; i < text_.size(); i++) {
+            bytes += text_[i].size() + 1;
+        }
+        return bytes;
+    }
+    
+    // returns the table shared by every Product
+    UnitTable& units() {
+        static UnitTable table;
+        return table;
+    }
+    
+}
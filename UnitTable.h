@@ -0,0 +1,56 @@
+/* --------------------------------------------
+ Description: This is the header file for UnitTable.cpp. It declares the UnitTable class which interns unit of measure strings, so a product stores a 16-bit unit id instead of its own copy of the unit text.
+ ----------------------------------------------- */
+
+#ifndef AMA_UNITTABLE_H_
+#define AMA_UNITTABLE_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace AMA {
+    
+    // number of ids a table has room for, id 0 is always the empty unit
+    const int max_units = 65536;
+    
+    // returned by intern() when the table is full, never the id of a unit
+    const uint16_t no_unit = max_units - 1;
+    
+    class UnitTable {
+        
+        static const int chunk_size = 256;
+        
+        mutable std::mutex mutex_;              // guards ids_ and text_
+        std::unordered_map<std::string, uint16_t> ids_;
+        std::deque<std::string> text_;          // deque keeps every string at a fixed address
+        std::atomic<const char**> chunks_[max_units / chunk_size];
+        std::atomic<int> size_;
+        
+    public:
+        UnitTable();
+        UnitTable(const UnitTable&) = delete;
+        UnitTable& operator=(const UnitTable&) = delete;
+        ~UnitTable();
+        
+        // returns the id of unit, adding it if it is new
+        // unit is cut to max_unit_length characters, a full table returns no_unit
+        uint16_t intern(const char* unit);
+        
+        // returns the text of id without locking, "" for an id that was never returned by intern()
+        const char* name(uint16_t id) const;
+        
+        int size() const;
+        size_t memoryUsage() const;
+        
+    };
+    
+    // returns the table shared by every Product
+    UnitTable& units();
+    
+}
+
+#endif
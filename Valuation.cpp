@@ -0,0 +1,87 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for inventory valuation. The parallel version splits the products into fixed chunks, sums each chunk with Kahan compensation and combines the chunk sums pairwise in a fixed order, so the floating-point result never depends on how the chunks were scheduled.
+ ----------------------------------------------- */
+
+#include <thread>
+#include <vector>
+#include "Valuation.h"
+
+namespace AMA {
+    
+    // returns the compensated sum of total cost for products [from, to)
+    static double chunkSum(const iProduct* const* products, int from, int to) {
+        double sum = 0.0;
+        double carry = 0.0;
+        for(int i = from; i < to; i++) {
+            double y = products[i]->total_cost() - carry;
+            double t = sum + y;
+            carry = (t - sum) - y;
+            sum = t;
+        }
+        return sum;
+    }
+    
+    // sums partial results pairwise, the pairing only depends on the number of partials
+    static double treeSum(std::vector<double>& partial) {
+        size_t n = partial.size();
+        while(n > 1) {
+            size_t half = (n + 1) / 2;
+            for(size_t i = 0; i + half < n; i++) {
+                partial[i] += partial[i + half];
+            }
+            n = half;
+        }
+        return n == 0 ? 0.0 : partial[0];
+    }
+    
+    // returns the total cost of all products using the += helper in a single loop
+    double valuation(const iProduct* const* products, int count) {
+        double total = 0.0;
+        for(int i = 0; i < count; i++) {
+            total += *products[i];
+        }
+        return total;
+    }
+    
+    // returns the total cost of all products summed by a fixed-shape tree over compensated chunk sums
+    double parallelValuation(const iProduct* const* products, int count, int threads) {
+        
+        if(products == nullptr || count <= 0) {
+            return 0.0;
+        }
+        
+        int chunks = (count + valuation_chunk - 1) / valuation_chunk;
+        std::vector<double> partial(chunks, 0.0);
+        
+        if(threads <= 0) {
+            threads = (int)std::thread::hardware_concurrency();
+        }
+        if(threads <= 0) {
+            threads = 1;
+        }
+        if(threads > chunks) {
+            threads = chunks;
+        }
+        
+        // each worker takes every threads-th chunk and writes only its own slots
+        auto worker = [&](int first) {
+            for(int c = first; c < chunks; c += threads) {
+                int from = c * valuation_chunk;
+                int to = from + valuation_chunk < count ? from + valuation_chunk : count;
+                partial[c] = chunkSum(products, from, to);
+            }
+        };
+        
+        std::vector<std::thread> pool;
+        for(int t = 1; t < threads; t++) {
+            pool.emplace_back(worker, t);
+        }
+        worker(0);
+        for(auto& th : pool) {
+            th.join();
+        }
+        
+        return treeSum(partial);
+    }
+    
+}
@@ -0,0 +1,25 @@
+/* --------------------------------------------
+ Description: This is the header file for Valuation.cpp. It contains declarations for the functions that total the cost of a loaded inventory, serially or split across threads, with results that do not depend on the number of threads used.
+ ----------------------------------------------- */
+
+#ifndef AMA_VALUATION_H_
+#define AMA_VALUATION_H_
+
+#include "iProduct.h"
+
+namespace AMA {
+    
+    // number of products summed together as one leaf of the reduction tree
+    // the shape of the tree depends only on this value and the product count
+    const int valuation_chunk = 1024;
+    
+    // returns the total cost of all products using the += helper in a single loop
+    double valuation(const iProduct* const* products, int count);
+    
+    // returns the total cost of all products summed by a fixed-shape tree over compensated chunk sums
+    // the result is bit-identical for any number of threads, 0 uses the number of hardware threads
+    double parallelValuation(const iProduct* const* products, int count, int threads = 0);
+    
+}
+
+#endif
@@ -0,0 +1,64 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for loading and saving a whole inventory through AsyncReader and AsyncWriter, to compare with inventory.load and the store() benchmarks.
+ ----------------------------------------------- */
+
+#include <stdio.h>
+#include <thread>
+#include "AsyncIO.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the asynchronous load and save benchmarks for one dataset
+    void asyncBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        long long size = (long long)recs.size();
+        std::string path = opt.tempPath("async.txt");
+        std::vector<iProduct*> products;
+        createProducts(recs, products);
+        writeRecords(path.c_str(), recs);
+        
+        long long bytes = 0;
+        FILE* file = fopen(path.c_str(), "rb");
+        if(file != nullptr) {
+            fseek(file, 0, SEEK_END);
+            bytes = ftell(file);
+            fclose(file);
+        }
+        
+        int maxThreads = opt.threads > 0 ? opt.threads : (int)std::thread::hardware_concurrency();
+        
+        for(int threads = 1; threads <= (maxThreads > 0 ? maxThreads : 1); threads *= 2) {
+            
+            std::string suffix = "." + std::to_string(threads);
+            
+            if(opt.selected("async.load.records" + suffix)) {
+                std::vector<Record> loaded;
+                out.report(measure(opt, "async.load.records" + suffix, size, nullptr, [&]() {
+                    return loadRecords(path.c_str(), loaded, threads);
+                }, bytes));
+            }
+            
+            if(opt.selected("async.load.products" + suffix)) {
+                std::vector<iProduct*> loaded;
+                out.report(measure(opt, "async.load.products" + suffix, size, [&]() {
+                    destroyProducts(loaded);
+                }, [&]() {
+                    return loadProducts(path.c_str(), loaded, threads);
+                }, bytes));
+                destroyProducts(loaded);
+            }
+            
+            if(opt.selected("async.save" + suffix)) {
+                out.report(measure(opt, "async.save" + suffix, size, nullptr, [&]() {
+                    saveProducts(path.c_str(), products.data(), (int)products.size(), threads);
+                    return size;
+                }, bytes));
+            }
+        }
+        
+        destroyProducts(products);
+        remove(path.c_str());
+    }
+    
+}
@@ -0,0 +1,91 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the benchmark options, the measurement loop and the result reporter.
+ ----------------------------------------------- */
+
+#include <iomanip>
+#include <unistd.h>
+#include "Memory.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // sets options to the defaults used when no arguments are given
+    BenchOptions::BenchOptions() {
+        sizes.push_back(1000);
+        sizes.push_back(100000);
+        minTime = 0.2;
+        threads = 0;
+        dir = "/tmp";
+    }
+    
+    // returns a path for a temporary file in dir, unique to this process
+    std::string BenchOptions::tempPath(const char* name) const {
+        return dir + "/ama_bench_" + std::to_string(getpid()) + "_" + name;
+    }
+    
+    // returns true if the benchmark name passes the filter
+    bool BenchOptions::selected(const std::string& name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+    
+    // prints to os as CSV if csv is true, JSON lines otherwise
+    BenchReporter::BenchReporter(std::ostream& os, bool csv) : os_(os) {
+        csv_ = csv;
+        header_ = false;
+    }
+    
+    // prints one result with its derived rates
+    void BenchReporter::report(const BenchResult& res) {
+        
+        double perIteration = res.iterations > 0 ? res.seconds / res.iterations : 0.0;
+        double recordsPerSec = perIteration > 0 ? res.records / perIteration : 0.0;
+        double bytesPerSec = perIteration > 0 ? res.bytes / perIteration : 0.0;
+        double allocsPerRecord = res.iterations > 0 && res.records > 0 ? double(res.allocations) / res.iterations / res.records : 0.0;
+        
+        os_ << std::setprecision(6);
+        
+        if(csv_) {
+            if(!header_) {
+                os_ << "bench,size,records,bytes,iterations,seconds,records_per_sec,bytes_per_sec,allocs_per_record" << std::endl;
+                header_ = true;
+            }
+            os_ << res.name << ',' << res.size << ',' << res.records << ',' << res.bytes << ',' << res.iterations << ','
+            << perIteration << ',' << recordsPerSec << ',' << bytesPerSec << ',' << allocsPerRecord << std::endl;
+        } else {
+            os_ << "{\"bench\":\"" << res.name << "\",\"size\":" << res.size << ",\"records\":" << res.records
+            << ",\"bytes\":" << res.bytes << ",\"iterations\":" << res.iterations << ",\"seconds\":" << perIteration
+            << ",\"records_per_sec\":" << recordsPerSec << ",\"bytes_per_sec\":" << bytesPerSec
+            << ",\"allocs_per_record\":" << allocsPerRecord << "}" << std::endl;
+        }
+    }
+    
+    // runs work until at least minTime seconds have passed
+    BenchResult measure(const BenchOptions& opt, const std::string& name, long long size,
+                        const std::function<void()>& setup, const std::function<long long()>& work, long long bytes) {
+        
+        BenchResult res;
+        res.name = name;
+        res.size = size;
+        res.records = 0;
+        res.bytes = bytes;
+        res.iterations = 0;
+        res.seconds = 0.0;
+        res.allocations = 0;
+        
+        do {
+            if(setup) {
+                setup();
+            }
+            long long allocs = allocationStats().allocations;
+            auto start = std::chrono::steady_clock::now();
+            res.records = work();
+            auto stop = std::chrono::steady_clock::now();
+            res.allocations += allocationStats().allocations - allocs;
+            res.seconds += std::chrono::duration<double>(stop - start).count();
+            res.iterations++;
+        } while(res.seconds < opt.minTime);
+        
+        return res;
+    }
+    
+}
@@ -0,0 +1,80 @@
+/* --------------------------------------------
+ Description: This is the header file for the benchmark driver. It declares the options shared by every benchmark, the result of one measurement, the reporter that prints results as JSON lines or CSV, and the benchmark groups run by main.cpp.
+ ----------------------------------------------- */
+
+#ifndef AMA_BENCH_H_
+#define AMA_BENCH_H_
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Generator.h"
+
+namespace AMA {
+    
+    struct BenchOptions {
+        std::vector<long long> sizes;           // dataset sizes, in records
+        GeneratorOptions generator;
+        double minTime;                         // seconds each measurement runs for at least
+        int threads;                            // largest thread count for parallel benchmarks
+        std::string dir;                        // directory for temporary files
+        std::string filter;                     // only run benchmarks whose name contains filter
+        
+        BenchOptions();
+        std::string tempPath(const char* name) const;
+        bool selected(const std::string& name) const;
+    };
+    
+    struct BenchResult {
+        std::string name;
+        long long size;                         // dataset size
+        long long records;                      // records processed per iteration
+        long long bytes;                        // bytes processed per iteration
+        long long iterations;
+        double seconds;                         // total time of all iterations
+        long long allocations;                  // allocations of all iterations
+    };
+    
+    class BenchReporter {
+        
+        std::ostream& os_;
+        bool csv_;
+        bool header_;
+        
+    public:
+        BenchReporter(std::ostream& os, bool csv);
+        void report(const BenchResult& res);
+        
+    };
+    
+    // runs work until at least minTime seconds have passed and fills in iterations, seconds and allocations
+    // setup runs before each iteration and is not timed, work returns the records it processed
+    BenchResult measure(const BenchOptions& opt, const std::string& name, long long size,
+                        const std::function<void()>& setup, const std::function<long long()>& work, long long bytes = 0);
+    
+    // benchmark groups
+    void fileBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void valuationBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void indexBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void asyncBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void poolBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void compactBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void changeBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void sharedBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void shardBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void reconcileBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void sortBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void consolidateBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void scanBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void schemaBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void latencyBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void memoryBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void reloadBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void historyBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    void exportBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out);
+    
+}
+
+#endif
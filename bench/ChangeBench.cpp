@@ -0,0 +1,68 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks measuring the cost of publishing quantity changes to a ChangeStream, with publishing off, on without readers and on with subscribers draining the ring on their own threads.
+ ----------------------------------------------- */
+
+#include <atomic>
+#include <thread>
+#include "ChangeStream.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the change stream benchmarks for one dataset
+    void changeBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        std::vector<iProduct*> products;
+        createProducts(recs, products);
+        
+        long long size = (long long)recs.size();
+        int round = 0;
+        
+        // sets every quantity once, so each call is a change
+        auto update = [&]() {
+            round++;
+            for(size_t i = 0; i < products.size(); i++) {
+                products[i]->quantity(recs[i].qty + round);
+            }
+            return size;
+        };
+        
+        if(opt.selected("change.quantity.off")) {
+            out.report(measure(opt, "change.quantity.off", size, nullptr, update));
+        }
+        
+        ChangeStream stream;
+        
+        if(opt.selected("change.quantity.on")) {
+            changeStream(&stream);
+            out.report(measure(opt, "change.quantity.on", size, nullptr, update));
+            changeStream(nullptr);
+        }
+        
+        if(opt.selected("change.quantity.subscribed")) {
+            std::atomic<bool> done(false);
+            std::vector<std::thread> readers;
+            for(int t = 0; t < 2; t++) {
+                readers.push_back(std::thread([&]() {
+                    ChangeSubscriber sub(stream);
+                    ChangeEvent ev;
+                    while(!done.load(std::memory_order_relaxed)) {
+                        if(!sub.poll(ev)) {
+                            std::this_thread::yield();
+                        }
+                    }
+                }));
+            }
+            changeStream(&stream);
+            out.report(measure(opt, "change.quantity.subscribed", size, nullptr, update));
+            changeStream(nullptr);
+            done = true;
+            for(size_t t = 0; t < readers.size(); t++) {
+                readers[t].join();
+            }
+        }
+        
+        destroyProducts(products);
+    }
+    
+}
@@ -0,0 +1,59 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks comparing valuation and shortfall scans over an array of Product objects with the same scans over a CompactInventory.
+ ----------------------------------------------- */
+
+#include "CompactInventory.h"
+#include "Valuation.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the hot/cold layout benchmarks for one dataset
+    void compactBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        std::vector<iProduct*> products;
+        createProducts(recs, products);
+        
+        CompactInventory compact;
+        compact.build(products.data(), (int)products.size());
+        
+        long long size = (long long)recs.size();
+        volatile double sink = 0.0;
+        
+        if(opt.selected("layout.product.valuation")) {
+            out.report(measure(opt, "layout.product.valuation", size, nullptr, [&]() {
+                sink = valuation(products.data(), (int)products.size());
+                return size;
+            }, (long long)(products.size() * sizeof(Product))));
+        }
+        
+        if(opt.selected("layout.compact.valuation")) {
+            out.report(measure(opt, "layout.compact.valuation", size, nullptr, [&]() {
+                sink = compact.valuation();
+                return size;
+            }, (long long)(compact.size() * sizeof(HotRecord))));
+        }
+        
+        if(opt.selected("layout.product.shortfall")) {
+            out.report(measure(opt, "layout.product.shortfall", size, nullptr, [&]() {
+                int count = 0;
+                for(size_t i = 0; i < products.size(); i++) {
+                    count += products[i]->quantity() < products[i]->qtyNeeded();
+                }
+                sink = count;
+                return size;
+            }, (long long)(products.size() * sizeof(Product))));
+        }
+        
+        if(opt.selected("layout.compact.shortfall")) {
+            out.report(measure(opt, "layout.compact.shortfall", size, nullptr, [&]() {
+                sink = compact.shortfall();
+                return size;
+            }, (long long)(compact.size() * sizeof(HotRecord))));
+        }
+        
+        (void)sink;
+        destroyProducts(products);
+    }
+    
+}
@@ -0,0 +1,65 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmark for the Consolidator merging eight sku-sorted warehouse files, each holding about two thirds of the dataset with one record in 50 at a different price.
+ ----------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include "Consolidate.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the consolidation benchmark for one dataset
+    void consolidateBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        if(!opt.selected("consolidate.8")) {
+            return;
+        }
+        
+        std::vector<Record> sorted(recs);
+        std::sort(sorted.begin(), sorted.end(), [](const Record& a, const Record& b) {
+            return strcmp(a.sku, b.sku) < 0;
+        });
+        
+        const int warehouses = 8;
+        std::vector<std::string> inputs;
+        long long bytes = 0;
+        
+        for(int w = 0; w < warehouses; w++) {
+            std::vector<Record> part;
+            for(size_t i = 0; i < sorted.size(); i++) {
+                if((i + w) % 3 != 0) {
+                    Record rec = sorted[i];
+                    if((i + w) % 50 == 0) {
+                        rec.price += 1;
+                    }
+                    part.push_back(rec);
+                }
+            }
+            inputs.push_back(opt.tempPath(("warehouse-" + std::to_string(w) + ".txt").c_str()));
+            writeRecords(inputs.back().c_str(), part);
+            
+            FILE* file = fopen(inputs.back().c_str(), "rb");
+            if(file != nullptr) {
+                fseek(file, 0, SEEK_END);
+                bytes += ftell(file);
+                fclose(file);
+            }
+        }
+        
+        std::string output = opt.tempPath("consolidated.txt");
+        Consolidator consolidator;
+        out.report(measure(opt, "consolidate.8", (long long)recs.size(), nullptr, [&]() {
+            consolidator.run(inputs, output.c_str());
+            return consolidator.stats().records;
+        }, bytes));
+        
+        for(size_t i = 0; i < inputs.size(); i++) {
+            remove(inputs[i].c_str());
+        }
+        remove(output.c_str());
+    }
+    
+}
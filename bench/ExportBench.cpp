@@ -0,0 +1,65 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for the JSON lines and CSV exporters: formatting records into one buffer on a single thread, and exporting a whole inventory to a file on increasing numbers of threads.
+ ----------------------------------------------- */
+
+#include <stdio.h>
+#include <thread>
+#include "Export.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the export benchmarks for one dataset
+    void exportBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        long long size = (long long)recs.size();
+        std::string path = opt.tempPath("export.out");
+        std::vector<iProduct*> products;
+        createProducts(recs, products);
+        
+        int maxThreads = opt.threads > 0 ? opt.threads : (int)std::thread::hardware_concurrency();
+        
+        const ExportFormat formats[] = { export_json, export_csv };
+        const char* names[] = { "json", "csv" };
+        
+        for(int f = 0; f < 2; f++) {
+            
+            std::string name = std::string("export.") + names[f];
+            
+            // formats every record once to size the output and the buffer
+            std::vector<char> buffer(max_export_length);
+            long long bytes = exportHeader(formats[f], buffer.data());
+            for(size_t i = 0; i < recs.size(); i++) {
+                bytes += exportRecord(recs[i], formats[f], buffer.data());
+            }
+            buffer.resize((size_t)bytes + max_export_length);
+            
+            if(opt.selected(name + ".format")) {
+                long long written = 0;
+                out.report(measure(opt, name + ".format", size, nullptr, [&]() {
+                    char* p = buffer.data();
+                    p += exportHeader(formats[f], p);
+                    for(size_t i = 0; i < recs.size(); i++) {
+                        p += exportRecord(recs[i], formats[f], p);
+                    }
+                    written = p - buffer.data();
+                    return size;
+                }, bytes));
+            }
+            
+            for(int threads = 1; threads <= (maxThreads > 0 ? maxThreads : 1); threads *= 2) {
+                std::string test = name + "." + std::to_string(threads);
+                if(opt.selected(test)) {
+                    out.report(measure(opt, test, size, nullptr, [&]() {
+                        exportProducts(path.c_str(), products.data(), (int)products.size(), formats[f], threads);
+                        return size;
+                    }, bytes));
+                }
+            }
+        }
+        
+        destroyProducts(products);
+        remove(path.c_str());
+    }
+    
+}
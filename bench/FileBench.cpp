@@ -0,0 +1,192 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for the record hot paths: store() and load() through std::fstream, write() and read() through string streams, Date::read() and Date::write(), and the RecordReader line parser.
+ ----------------------------------------------- */
+
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include "Perishable.h"
+#include "RecordReader.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // returns the size of the file at path
+    static long long fileSize(const std::string& path) {
+        std::ifstream file(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+        return file ? (long long)file.tellg() : 0;
+    }
+    
+    // writes every product to path with store()
+    static long long storeAll(const std::string& path, const std::vector<iProduct*>& products) {
+        std::fstream file(path.c_str(), std::ios::out | std::ios::trunc);
+        for(size_t i = 0; i < products.size(); i++) {
+            products[i]->store(file);
+        }
+        return (long long)products.size();
+    }
+    
+    // loads every record of path the way the inventory application does
+    // reads the type and comma, then calls load() on an object of that type
+    static long long loadAll(const std::string& path) {
+        std::fstream file(path.c_str(), std::ios::in);
+        Product product;
+        Perishable perishable;
+        long long count = 0;
+        char type;
+        while(file >> type) {
+            file.ignore(1);
+            iProduct& target = type == 'P' ? static_cast<iProduct&>(perishable) : product;
+            target.load(file);
+            if(file.fail()) {
+                break;
+            }
+            count++;
+        }
+        return count;
+    }
+    
+    // returns the answers Product::read() and Perishable::read() expect for rec
+    static void readInput(const Record& rec, std::ostream& os) {
+        os << "Sku: " << rec.sku << '\n' << "Name: " << rec.name << '\n' << "Unit: " << rec.unit << '\n'
+        << "Taxed? (y/n): " << (rec.taxed ? 'y' : 'n') << '\n' << "Price: " << rec.price << '\n'
+        << "Quantity on hand: " << rec.qty << '\n' << "Quantity needed: " << rec.qtyNeeded << '\n';
+        if(rec.type == 'P') {
+            os << "Expiry date (YYYY/MM/DD): " << Date::fromDayNumber(rec.expiry) << '\n';
+        }
+    }
+    
+    // runs the fstream, string stream and Date benchmarks for one dataset
+    void fileBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        long long size = (long long)recs.size();
+        std::vector<Record> plain;
+        std::vector<Record> perishable;
+        
+        for(size_t i = 0; i < recs.size(); i++) {
+            (recs[i].type == 'P' ? perishable : plain).push_back(recs[i]);
+        }
+        
+        std::string path = opt.tempPath("records.txt");
+        
+        const std::vector<Record>* sets[2] = { &plain, &perishable };
+        const char* names[2] = { "product", "perishable" };
+        
+        for(int s = 0; s < 2; s++) {
+            
+            std::vector<iProduct*> products;
+            createProducts(*sets[s], products);
+            std::string name = names[s];
+            
+            if(opt.selected(name + ".store")) {
+                BenchResult res = measure(opt, name + ".store", size, nullptr, [&]() {
+                    return storeAll(path, products);
+                });
+                res.bytes = fileSize(path);
+                out.report(res);
+            }
+            
+            if(opt.selected(name + ".load")) {
+                writeRecords(path.c_str(), *sets[s]);
+                out.report(measure(opt, name + ".load", size, nullptr, [&]() {
+                    return loadAll(path);
+                }, fileSize(path)));
+            }
+            
+            if(opt.selected(name + ".write")) {
+                std::ostringstream os;
+                BenchResult res = measure(opt, name + ".write", size, [&]() {
+                    os.str("");
+                }, [&]() {
+                    for(size_t i = 0; i < products.size(); i++) {
+                        products[i]->write(os, true) << '\n';
+                    }
+                    return (long long)products.size();
+                });
+                res.bytes = (long long)os.str().size();
+                out.report(res);
+            }
+            
+            if(opt.selected(name + ".read")) {
+                std::ostringstream input;
+                for(size_t i = 0; i < sets[s]->size(); i++) {
+                    readInput((*sets[s])[i], input);
+                }
+                std::string text = input.str();
+                out.report(measure(opt, name + ".read", size, nullptr, [&]() {
+                    std::istringstream is(text);
+                    Product product;
+                    Perishable perishable;
+                    iProduct& target = s == 1 ? static_cast<iProduct&>(perishable) : product;
+                    long long count = 0;
+                    for(size_t i = 0; i < products.size() && is; i++) {
+                        target.read(is);
+                        count++;
+                    }
+                    return count;
+                }, (long long)text.size()));
+            }
+            
+            destroyProducts(products);
+        }
+        
+        if(opt.selected("inventory.load")) {
+            writeRecords(path.c_str(), recs);
+            out.report(measure(opt, "inventory.load", size, nullptr, [&]() {
+                return loadAll(path);
+            }, fileSize(path)));
+        }
+        
+        if(opt.selected("reader.next")) {
+            writeRecords(path.c_str(), recs);
+            out.report(measure(opt, "reader.next", size, nullptr, [&]() {
+                RecordReader reader;
+                Record rec;
+                long long count = 0;
+                reader.open(path.c_str());
+                while(reader.next(rec)) {
+                    count++;
+                }
+                return count;
+            }, fileSize(path)));
+        }
+        
+        std::vector<Date> dates;
+        for(size_t i = 0; i < perishable.size(); i++) {
+            dates.push_back(Date::fromDayNumber(perishable[i].expiry));
+        }
+        
+        std::ostringstream os;
+        for(size_t i = 0; i < dates.size(); i++) {
+            dates[i].write(os) << '\n';
+        }
+        std::string text = os.str();
+        
+        if(opt.selected("date.write")) {
+            std::ostringstream dos;
+            out.report(measure(opt, "date.write", size, [&]() {
+                dos.str("");
+            }, [&]() {
+                for(size_t i = 0; i < dates.size(); i++) {
+                    dates[i].write(dos) << '\n';
+                }
+                return (long long)dates.size();
+            }, (long long)text.size()));
+        }
+        
+        if(opt.selected("date.read")) {
+            out.report(measure(opt, "date.read", size, nullptr, [&]() {
+                std::istringstream is(text);
+                Date date;
+                long long count = 0;
+                while(date.read(is)) {
+                    count++;
+                }
+                return count;
+            }, (long long)text.size()));
+        }
+        
+        remove(path.c_str());
+    }
+    
+}
@@ -0,0 +1,111 @@
+/* --------------------------------------------
+ Description: This implementation file contains definitions for the synthetic inventory generator. Skus are unique, six base-36 characters long and shuffled, so records are not already in sku order.
+ ----------------------------------------------- */
+
+#include <random>
+#include <stdio.h>
+#include <string>
+#include <string.h>
+#include "Date.h"
+#include "Generator.h"
+
+namespace AMA {
+    
+    // sets the default mix of a third perishable records
+    GeneratorOptions::GeneratorOptions() {
+        perishable = 0.3;
+        nameLength = 9;
+        unitLength = 6;
+        units = 40;
+        expirySpread = 3 * 365;
+        seed = 2018;
+    }
+    
+    // fills buf with length random lower case letters
+    static void randomText(std::mt19937& rng, char* buf, int length) {
+        for(int i = 0; i < length; i++) {
+            buf[i] = (char)('a' + rng() % 26);
+        }
+        buf[length] = '\0';
+    }
+    
+    // fills recs with count records, the same options and count always produce the same records
+    void generate(const GeneratorOptions& opt, long long count, std::vector<Record>& recs) {
+        
+        std::mt19937 rng(opt.seed);
+        
+        // Product::load() reads at most max_sku_length - 1 and max_name_length - 1 characters
+        int nameLength = opt.nameLength < 1 ? 1 : (opt.nameLength > max_name_length - 1 ? max_name_length - 1 : opt.nameLength);
+        int unitLength = opt.unitLength < 1 ? 1 : (opt.unitLength > max_unit_length - 1 ? max_unit_length - 1 : opt.unitLength);
+        
+        std::vector<std::string> units(opt.units > 0 ? opt.units : 1);
+        for(size_t i = 0; i < units.size(); i++) {
+            char buf[max_unit_length + 1];
+            randomText(rng, buf, 1 + rng() % unitLength);
+            units[i] = buf;
+        }
+        
+        int firstDay = daysFromCivil(2019, 1, 1);
+        int spread = opt.expirySpread > 0 ? opt.expirySpread : 1;
+        
+        recs.resize(count);
+        
+        for(long long i = 0; i < count; i++) {
+            
+            Record& rec = recs[i];
+            clear(rec);
+            
+            // multiplying by an odd constant modulo 2^31 visits every id once, 2^31 < 36^6
+            unsigned long long id = (i * 2654435761ULL) % 2147483648ULL;
+            for(int k = 5; k >= 0; k--, id /= 36) {
+                rec.sku[k] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[id % 36];
+            }
+            randomText(rng, rec.name, 1 + rng() % nameLength);
+            strncpy(rec.unit, units[rng() % units.size()].c_str(), max_unit_length);
+            
+            rec.type = (rng() % 1000) < opt.perishable * 1000 ? 'P' : 'N';
+            rec.taxed = rng() % 2 == 0;
+            rec.price = (rng() % 100000) / 100.0;
+            rec.qty = rng() % 1000;
+            rec.qtyNeeded = rng() % 1000;
+            
+            if(rec.type == 'P') {
+                rec.expiry = firstDay + rng() % spread;
+            }
+        }
+    }
+    
+    // writes recs to path in the format written by store()
+    bool writeRecords(const char* path, const std::vector<Record>& recs) {
+        
+        FILE* file = fopen(path, "wb");
+        char buf[max_record_length];
+        
+        if(file == nullptr) {
+            return false;
+        }
+        
+        for(size_t i = 0; i < recs.size(); i++) {
+            fwrite(buf, 1, formatRecord(recs[i], buf), file);
+        }
+        
+        return fclose(file) == 0;
+    }
+    
+    // creates a Product or Perishable for each record
+    void createProducts(const std::vector<Record>& recs, std::vector<iProduct*>& products) {
+        products.resize(recs.size());
+        for(size_t i = 0; i < recs.size(); i++) {
+            products[i] = createFromRecord(recs[i]);
+        }
+    }
+    
+    // deletes products created by createProducts()
+    void destroyProducts(std::vector<iProduct*>& products) {
+        for(size_t i = 0; i < products.size(); i++) {
+            delete products[i];
+        }
+        products.clear();
+    }
+    
+}
@@ -0,0 +1,36 @@
+/* --------------------------------------------
+ Description: This is the header file for Generator.cpp. It declares the synthetic inventory generator used by the benchmarks.
+ ----------------------------------------------- */
+
+#ifndef AMA_GENERATOR_H_
+#define AMA_GENERATOR_H_
+
+#include <vector>
+#include "Record.h"
+
+namespace AMA {
+    
+    struct GeneratorOptions {
+        double perishable;                      // fraction of records that are perishable
+        int nameLength;                         // longest generated name
+        int unitLength;                         // longest generated unit
+        int units;                              // number of distinct units
+        int expirySpread;                       // expiry dates fall within this many days
+        unsigned seed;
+        
+        GeneratorOptions();
+    };
+    
+    // fills recs with count records, the same options and count always produce the same records
+    void generate(const GeneratorOptions& opt, long long count, std::vector<Record>& recs);
+    
+    // writes recs to path in the format written by store()
+    bool writeRecords(const char* path, const std::vector<Record>& recs);
+    
+    // creates a Product or Perishable for each record, the caller deletes them
+    void createProducts(const std::vector<Record>& recs, std::vector<iProduct*>& products);
+    void destroyProducts(std::vector<iProduct*>& products);
+    
+}
+
+#endif
@@ -0,0 +1,86 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for the quantity history: appending hourly samples for every sku of a dataset, reported with the packed bytes they take, and range queries and daily rollups over one month of a sku.
+ ----------------------------------------------- */
+
+#include "History.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // hourly samples appended per sku
+    static const int history_hours = 24 * 30;
+    
+    // appends history_hours samples for each record, the quantity drifting as if sold and restocked
+    static long long fill(QuantityHistory& history, const std::vector<Record>& recs, int64_t start) {
+        long long added = 0;
+        for(size_t i = 0; i < recs.size(); i++) {
+            int qty = recs[i].qty;
+            for(int h = 0; h < history_hours; h++) {
+                if(h % 7 == (int)(i % 7)) {
+                    qty = qty > 0 ? qty - 1 : recs[i].qty;
+                }
+                added += history.append(recs[i].sku, start + h * 3600, qty, recs[i].qtyNeeded);
+            }
+        }
+        history.seal();
+        return added;
+    }
+    
+    // runs the quantity history benchmarks for one dataset
+    void historyBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        if(recs.empty()) {
+            return;
+        }
+        
+        int64_t start = (int64_t)Date(2020, 1, 1).dayNumber() * seconds_per_day;
+        
+        // a month of samples for a million skus takes too long to be worth timing twice
+        std::vector<Record> sample(recs.begin(), recs.begin() + (recs.size() < 10000 ? recs.size() : 10000));
+        long long samples = (long long)sample.size() * history_hours;
+        
+        if(opt.selected("history.append")) {
+            size_t packed = 0;
+            BenchResult res = measure(opt, "history.append", samples, nullptr, [&]() {
+                QuantityHistory history;
+                long long added = fill(history, sample, start);
+                packed = history.stats().packedBytes;
+                return added;
+            });
+            res.bytes = (long long)packed;
+            out.report(res);
+        }
+        
+        QuantityHistory history;
+        fill(history, sample, start);
+        
+        if(opt.selected("history.range")) {
+            out.report(measure(opt, "history.range", samples, nullptr, [&]() {
+                long long visited = 0;
+                for(size_t i = 0; i < sample.size(); i++) {
+                    history.range(sample[i].sku, start + 10 * seconds_per_day, start + 17 * seconds_per_day, [&](const HistorySample&) {
+                        visited++;
+                        return true;
+                    });
+                }
+                return visited;
+            }));
+        }
+        
+        if(opt.selected("history.rollup")) {
+            Date first = Date::fromDayNumber((int)(start / seconds_per_day));
+            Date last = Date::fromDayNumber((int)(start / seconds_per_day) + 29);
+            out.report(measure(opt, "history.rollup", (long long)sample.size(), nullptr, [&]() {
+                long long days = 0;
+                for(size_t i = 0; i < sample.size(); i++) {
+                    history.rollup(sample[i].sku, first, last, [&](const DailyRollup&) {
+                        days++;
+                        return true;
+                    });
+                }
+                return days;
+            }));
+        }
+    }
+    
+}
@@ -0,0 +1,168 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for SkuIndex and NameIndex: bulk build, point and range lookups against a linear scan with Product::operator>, and exact, prefix and fuzzy name lookup latency.
+ ----------------------------------------------- */
+
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include "NameIndex.h"
+#include "SkuIndex.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // number of lookups timed per iteration
+    static const int index_queries = 1000;
+    
+    // runs the index benchmarks for one dataset
+    void indexBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        if(recs.empty()) {
+            return;
+        }
+        
+        std::vector<iProduct*> products;
+        createProducts(recs, products);
+        
+        const iProduct* const* data = products.data();
+        int count = (int)products.size();
+        long long size = (long long)recs.size();
+        volatile long long sink = 0;
+        
+        std::vector<std::string> skus;
+        for(size_t i = 0; i < recs.size(); i++) {
+            skus.push_back(recs[i].sku);
+        }
+        std::sort(skus.begin(), skus.end());
+        
+        // ranges of about 100 skus starting at evenly spread positions
+        int width = count > 100 ? 100 : count - 1;
+        auto rangeStart = [&](int q) {
+            return (int)((long long)q * (count - width) / index_queries);
+        };
+        
+        SkuIndex skuIndex;
+        
+        if(opt.selected("sku.build")) {
+            out.report(measure(opt, "sku.build", size, nullptr, [&]() {
+                skuIndex.build(data, count, 1);
+                return size;
+            }));
+            out.report(measure(opt, "sku.build.parallel", size, nullptr, [&]() {
+                skuIndex.build(data, count, opt.threads);
+                return size;
+            }));
+        }
+        
+        skuIndex.build(data, count, opt.threads);
+        
+        if(opt.selected("sku.find")) {
+            out.report(measure(opt, "sku.find", size, nullptr, [&]() {
+                long long found = 0;
+                for(int q = 0; q < index_queries; q++) {
+                    found += skuIndex.find(recs[q % count].sku) >= 0;
+                }
+                sink = found;
+                return (long long)index_queries;
+            }));
+        }
+        
+        if(opt.selected("sku.range")) {
+            out.report(measure(opt, "sku.range", size, nullptr, [&]() {
+                long long found = 0;
+                for(int q = 0; q < index_queries; q++) {
+                    int lo = rangeStart(q);
+                    skuIndex.range(skus[lo].c_str(), skus[lo + width].c_str(), [&](const SkuEntry&) {
+                        found++;
+                        return true;
+                    });
+                }
+                sink = found;
+                return (long long)index_queries;
+            }));
+        }
+        
+        // the same ranges found by testing every product with operator>, so fewer queries are run
+        if(opt.selected("sku.range.scan")) {
+            int queries = size > 100000 ? 10 : 100;
+            BenchResult res = measure(opt, "sku.range.scan", size, nullptr, [&]() {
+                long long found = 0;
+                for(int q = 0; q < queries; q++) {
+                    int lo = rangeStart(q * (index_queries / queries));
+                    for(int i = 0; i < count; i++) {
+                        const Product& prd = static_cast<const Product&>(*data[i]);
+                        found += !(prd > skus[lo + width].c_str()) && (prd > skus[lo].c_str() || strcmp(prd.sku(), skus[lo].c_str()) == 0);
+                    }
+                }
+                sink = found;
+                return (long long)queries;
+            });
+            out.report(res);
+        }
+        
+        if(opt.selected("sku.prefix")) {
+            out.report(measure(opt, "sku.prefix", size, nullptr, [&]() {
+                long long found = 0;
+                for(int q = 0; q < index_queries; q++) {
+                    std::string prefix = skus[rangeStart(q)].substr(0, 3);
+                    skuIndex.prefix(prefix.c_str(), [&](const SkuEntry&) {
+                        found++;
+                        return true;
+                    });
+                }
+                sink = found;
+                return (long long)index_queries;
+            }));
+        }
+        
+        NameIndex nameIndex;
+        std::vector<uint64_t> result;
+        
+        if(opt.selected("name.build")) {
+            out.report(measure(opt, "name.build", size, nullptr, [&]() {
+                nameIndex.build(data, count);
+                return size;
+            }));
+        }
+        
+        nameIndex.build(data, count);
+        
+        if(opt.selected("name.exact")) {
+            out.report(measure(opt, "name.exact", size, nullptr, [&]() {
+                for(int q = 0; q < index_queries; q++) {
+                    nameIndex.exact(recs[q % count].name, result);
+                }
+                return (long long)index_queries;
+            }));
+        }
+        
+        if(opt.selected("name.prefix")) {
+            out.report(measure(opt, "name.prefix", size, nullptr, [&]() {
+                for(int q = 0; q < index_queries; q++) {
+                    std::string prefix = std::string(recs[q % count].name).substr(0, 3);
+                    nameIndex.prefix(prefix.c_str(), result, 20);
+                }
+                return (long long)index_queries;
+            }));
+        }
+        
+        if(opt.selected("name.fuzzy")) {
+            out.report(measure(opt, "name.fuzzy", size, nullptr, [&]() {
+                for(int q = 0; q < index_queries; q++) {
+                    // a typo in the second character
+                    char name[max_name_length + 1];
+                    strcpy(name, recs[q % count].name);
+                    if(name[1] != '\0') {
+                        name[1] = name[1] == 'z' ? 'a' : name[1] + 1;
+                    }
+                    nameIndex.fuzzy(name, 1, result, 20);
+                }
+                return (long long)index_queries;
+            }));
+        }
+        
+        (void)sink;
+        destroyProducts(products);
+    }
+    
+}
@@ -0,0 +1,99 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for latency recording: the cost of one LatencyTimer, SkuIndex::find() and Product::write() with recording off and on, and a histogram snapshot merged from several threads.
+ ----------------------------------------------- */
+
+#include <sstream>
+#include <thread>
+#include "Latency.h"
+#include "SkuIndex.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the latency recording benchmarks for one dataset
+    void latencyBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        if(recs.empty()) {
+            return;
+        }
+        
+        std::vector<iProduct*> products;
+        createProducts(recs, products);
+        
+        long long size = (long long)recs.size();
+        volatile long long sink = 0;
+        bool wasEnabled = latencyEnabled();
+        
+        SkuIndex index;
+        index.build(products.data(), (int)products.size(), opt.threads);
+        
+        if(opt.selected("latency.timer")) {
+            latencyEnabled(true);
+            out.report(measure(opt, "latency.timer", size, nullptr, [&]() {
+                for(long long i = 0; i < size; i++) {
+                    LatencyTimer timer(latency_lookup);
+                }
+                return size;
+            }));
+        }
+        
+        const char* modes[2] = { "off", "on" };
+        
+        for(int on = 0; on < 2; on++) {
+            
+            latencyEnabled(on == 1);
+            
+            std::string name = std::string("latency.find.") + modes[on];
+            if(opt.selected(name)) {
+                out.report(measure(opt, name, size, nullptr, [&]() {
+                    for(size_t i = 0; i < recs.size(); i++) {
+                        sink = sink + index.find(recs[i].sku);
+                    }
+                    return size;
+                }));
+            }
+            
+            name = std::string("latency.write.") + modes[on];
+            if(opt.selected(name)) {
+                std::ostringstream os;
+                out.report(measure(opt, name, size, [&]() {
+                    os.str("");
+                }, [&]() {
+                    for(size_t i = 0; i < products.size(); i++) {
+                        products[i]->write(os, true);
+                    }
+                    return size;
+                }));
+            }
+        }
+        
+        if(opt.selected("latency.snapshot")) {
+            
+            // leaves a recorder with counts behind for each thread
+            latencyEnabled(true);
+            std::vector<std::thread> workers;
+            for(int t = 0; t < opt.threads; t++) {
+                workers.emplace_back([&]() {
+                    for(size_t i = 0; i < recs.size(); i++) {
+                        index.find(recs[i].sku);
+                    }
+                });
+            }
+            for(size_t t = 0; t < workers.size(); t++) {
+                workers[t].join();
+            }
+            
+            LatencyHistogram histogram;
+            out.report(measure(opt, "latency.snapshot", 1, nullptr, [&]() {
+                latencySnapshot(latency_lookup, histogram);
+                sink = sink + (long long)histogram.percentile(99);
+                return 1LL;
+            }));
+        }
+        
+        latencyEnabled(wasEnabled);
+        latencyReset();
+        destroyProducts(products);
+    }
+    
+}
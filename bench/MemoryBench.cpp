@@ -0,0 +1,54 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for memory accounting: walking an inventory with MemoryReport, reported with the bytes it accounts for, and the live heap bytes the allocation hook sees while the same products are created.
+ ----------------------------------------------- */
+
+#include "Memory.h"
+#include "SkuIndex.h"
+#include "UnitTable.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the memory accounting benchmarks for one dataset
+    void memoryBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        long long size = (long long)recs.size();
+        
+        if(opt.selected("memory.account")) {
+            std::vector<iProduct*> products;
+            createProducts(recs, products);
+            SkuIndex index;
+            index.build(products.data(), (int)products.size(), opt.threads);
+            
+            size_t total = 0;
+            BenchResult res = measure(opt, "memory.account", size, nullptr, [&]() {
+                MemoryReport report;
+                report.account(products.data(), (int)products.size());
+                report.index("sku", index.memoryUsage());
+                report.index("units", units().memoryUsage());
+                total = report.total();
+                return size;
+            });
+            res.bytes = (long long)total;
+            out.report(res);
+            
+            destroyProducts(products);
+        }
+        
+        if(opt.selected("memory.heap")) {
+            long long grown = 0;
+            BenchResult res = measure(opt, "memory.heap", size, nullptr, [&]() {
+                std::vector<iProduct*> products;
+                products.reserve(recs.size());
+                long long before = allocationStats().liveBytes;
+                createProducts(recs, products);
+                grown = allocationStats().liveBytes - before;
+                destroyProducts(products);
+                return size;
+            });
+            res.bytes = grown;
+            out.report(res);
+        }
+    }
+    
+}
@@ -0,0 +1,76 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks comparing ProductPool with CreateProduct()/CreatePerishable() and delete, for a full construct then destroy cycle and for load, replace and discard churn.
+ ----------------------------------------------- */
+
+#include "ProductPool.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the object pool benchmarks for one dataset
+    void poolBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        long long size = (long long)recs.size();
+        ProductPool pool;
+        
+        if(opt.selected("factory.cycle")) {
+            std::vector<iProduct*> products(recs.size());
+            out.report(measure(opt, "factory.cycle", size, nullptr, [&]() {
+                for(size_t i = 0; i < recs.size(); i++) {
+                    products[i] = recs[i].type == 'P' ? CreatePerishable() : CreateProduct();
+                }
+                for(size_t i = 0; i < recs.size(); i++) {
+                    delete products[i];
+                }
+                return size;
+            }));
+        }
+        
+        if(opt.selected("pool.cycle")) {
+            std::vector<PooledProduct> products(recs.size());
+            out.report(measure(opt, "pool.cycle", size, nullptr, [&]() {
+                for(size_t i = 0; i < recs.size(); i++) {
+                    products[i] = pool.create(recs[i].type);
+                }
+                for(size_t i = 0; i < recs.size(); i++) {
+                    products[i].reset();
+                }
+                return size;
+            }));
+        }
+        
+        // replaces one product in 16 with a new object holding the record, as a reload does
+        if(opt.selected("factory.churn")) {
+            std::vector<iProduct*> products(recs.size());
+            for(size_t i = 0; i < recs.size(); i++) {
+                products[i] = recs[i].type == 'P' ? CreatePerishable() : CreateProduct();
+            }
+            out.report(measure(opt, "factory.churn", size, nullptr, [&]() {
+                for(size_t i = 0; i < recs.size(); i += 16) {
+                    delete products[i];
+                    products[i] = recs[i].type == 'P' ? CreatePerishable() : CreateProduct();
+                    fromRecord(recs[i], *products[i]);
+                }
+                return (size + 15) / 16;
+            }));
+            for(size_t i = 0; i < recs.size(); i++) {
+                delete products[i];
+            }
+        }
+        
+        if(opt.selected("pool.churn")) {
+            std::vector<PooledProduct> products(recs.size());
+            for(size_t i = 0; i < recs.size(); i++) {
+                products[i] = pool.create(recs[i].type);
+            }
+            out.report(measure(opt, "pool.churn", size, nullptr, [&]() {
+                for(size_t i = 0; i < recs.size(); i += 16) {
+                    products[i] = pool.create(recs[i].type);
+                    fromRecord(recs[i], *products[i]);
+                }
+                return (size + 15) / 16;
+            }));
+        }
+    }
+    
+}
@@ -0,0 +1,60 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for the Reconciler on a pair of inventory files that differ in about 2% of their skus, with the older file held in memory at once and with a budget small enough to force hash partitioning.
+ ----------------------------------------------- */
+
+#include <stdio.h>
+#include "Reconcile.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the reconciliation benchmarks for one dataset
+    void reconcileBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        if(!opt.selected("reconcile.memory") && !opt.selected("reconcile.partitioned")) {
+            return;
+        }
+        
+        // changes one sku in 100, removes one in 200 and adds as many new ones
+        std::vector<Record> today;
+        today.reserve(recs.size());
+        for(size_t i = 0; i < recs.size(); i++) {
+            Record rec = recs[i];
+            if(i % 200 == 7) {
+                sprintf(rec.sku, "n%05x", (unsigned)(i / 200) & 0xfffff);
+                today.push_back(rec);
+                continue;
+            }
+            if(i % 100 == 3) {
+                rec.qty++;
+            }
+            today.push_back(rec);
+        }
+        
+        std::string before = opt.tempPath("reconcile-before.txt");
+        std::string after = opt.tempPath("reconcile-after.txt");
+        writeRecords(before.c_str(), recs);
+        writeRecords(after.c_str(), today);
+        
+        long long size = (long long)recs.size();
+        
+        const char* names[2] = { "reconcile.memory", "reconcile.partitioned" };
+        size_t budgets[2] = { reconcile_memory, 1 << 20 };
+        
+        for(int b = 0; b < 2; b++) {
+            if(opt.selected(names[b])) {
+                Reconciler reconciler(budgets[b]);
+                out.report(measure(opt, names[b], size, nullptr, [&]() {
+                    reconciler.run(before.c_str(), after.c_str(), [](const Difference&) {
+                        return true;
+                    });
+                    return size;
+                }));
+            }
+        }
+        
+        remove(before.c_str());
+        remove(after.c_str());
+    }
+    
+}
@@ -0,0 +1,72 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for incremental reload: loading a whole file into an empty inventory, reloading a file that did not change, and reloading after a single record in the middle of the file changed.
+ ----------------------------------------------- */
+
+#include <stdio.h>
+#include "Reload.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // frees the products reload() created
+    static void release(std::vector<iProduct*>& products) {
+        for(size_t i = 0; i < products.size(); i++) {
+            delete products[i];
+        }
+        products.clear();
+    }
+    
+    // runs the incremental reload benchmarks for one dataset
+    void reloadBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        if(recs.empty()) {
+            return;
+        }
+        
+        long long size = (long long)recs.size();
+        std::string path = opt.tempPath("reload.txt");
+        std::string changedPath = opt.tempPath("reload.changed.txt");
+        
+        std::vector<Record> changed(recs);
+        changed[changed.size() / 2].qty++;
+        writeRecords(path.c_str(), recs);
+        writeRecords(changedPath.c_str(), changed);
+        
+        if(opt.selected("reload.full")) {
+            std::vector<iProduct*> products;
+            out.report(measure(opt, "reload.full", size, [&]() {
+                release(products);
+            }, [&]() {
+                Reloader reloader;
+                reloader.reload(path.c_str(), products);
+                return (long long)products.size();
+            }));
+            release(products);
+        }
+        
+        Reloader reloader;
+        std::vector<iProduct*> products;
+        reloader.reload(path.c_str(), products);
+        
+        if(opt.selected("reload.unchanged")) {
+            out.report(measure(opt, "reload.unchanged", size, nullptr, [&]() {
+                reloader.reload(path.c_str(), products);
+                return (long long)products.size();
+            }));
+        }
+        
+        if(opt.selected("reload.delta")) {
+            bool flip = false;
+            out.report(measure(opt, "reload.delta", size, nullptr, [&]() {
+                flip = !flip;
+                reloader.reload(flip ? changedPath.c_str() : path.c_str(), products);
+                return (long long)products.size();
+            }));
+        }
+        
+        release(products);
+        remove(path.c_str());
+        remove(changedPath.c_str());
+    }
+    
+}
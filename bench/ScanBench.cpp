@@ -0,0 +1,67 @@
+/* --------------------------------------------
+ Description: This implementation file contains the micro-benchmarks for the structural scanner at each level the processor supports, reported in bytes per second, and for parsing a buffer line by line against parsing it through a StructuralIndex.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include <string>
+#include "Scanner.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the structural scanner benchmarks for one dataset
+    void scanBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        std::string buffer;
+        char line[max_record_length];
+        for(size_t i = 0; i < recs.size(); i++) {
+            buffer.append(line, formatRecord(recs[i], line));
+        }
+        
+        const char* data = buffer.data();
+        size_t size = buffer.size();
+        long long records = (long long)recs.size();
+        std::vector<uint32_t> offsets(size);
+        
+        for(int level = scan_scalar; level <= scanLevel(); level++) {
+            std::string name = std::string("scan.") + scanLevelName((ScanLevel)level);
+            if(opt.selected(name)) {
+                out.report(measure(opt, name, records, nullptr, [&]() {
+                    scanStructure(data, size, ',', offsets.data(), (ScanLevel)level);
+                    return records;
+                }, (long long)size));
+            }
+        }
+        
+        volatile long long sink = 0;
+        
+        if(opt.selected("parse.lines")) {
+            out.report(measure(opt, "parse.lines", records, nullptr, [&]() {
+                Record rec;
+                long long parsed = 0;
+                const char* p = data;
+                const char* end = data + size;
+                while(p < end) {
+                    const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+                    if(nl == nullptr) {
+                        nl = end;
+                    }
+                    parsed += parseRecord(p, nl - p, rec);
+                    sink = sink + rec.qty;
+                    p = nl + 1;
+                }
+                return parsed;
+            }, (long long)size));
+        }
+        
+        if(opt.selected("parse.indexed")) {
+            out.report(measure(opt, "parse.indexed", records, nullptr, [&]() {
+                return parseRecords(data, size, [&](const Record& rec) {
+                    sink = sink + rec.qty;
+                    return true;
+                });
+            }, (long long)size));
+        }
+    }
+    
+}
@@ -0,0 +1,104 @@
+/* --------------------------------------------
+ Description: This implementation file contains the micro-benchmarks for the record schema: formatting, parsing, binary encoding and decoding, and report lines, to compare with the stream paths measured by product.store, product.load and product.write.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include <string>
+#include "Record.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the record schema benchmarks for one dataset
+    void schemaBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        long long records = (long long)recs.size();
+        
+        std::string text;
+        std::vector<uint32_t> ends;
+        char line[max_record_length];
+        for(size_t i = 0; i < recs.size(); i++) {
+            text.append(line, formatRecord(recs[i], line));
+            ends.push_back((uint32_t)text.size());
+        }
+        
+        std::vector<uint8_t> binary;
+        for(size_t i = 0; i < recs.size(); i++) {
+            encodeRecord(recs[i], binary);
+        }
+        
+        volatile long long sink = 0;
+        
+        if(opt.selected("schema.format")) {
+            std::string buffer;
+            BenchResult res = measure(opt, "schema.format", records, [&]() {
+                buffer.clear();
+            }, [&]() {
+                for(size_t i = 0; i < recs.size(); i++) {
+                    buffer.append(line, formatRecord(recs[i], line));
+                }
+                return records;
+            });
+            res.bytes = (long long)buffer.size();
+            out.report(res);
+        }
+        
+        if(opt.selected("schema.parse")) {
+            out.report(measure(opt, "schema.parse", records, nullptr, [&]() {
+                Record rec;
+                long long parsed = 0;
+                uint32_t begin = 0;
+                for(size_t i = 0; i < ends.size(); i++) {
+                    parsed += parseRecord(text.data() + begin, ends[i] - begin - 1, rec);
+                    sink = sink + rec.qty;
+                    begin = ends[i];
+                }
+                return parsed;
+            }, (long long)text.size()));
+        }
+        
+        if(opt.selected("schema.encode")) {
+            std::vector<uint8_t> buffer;
+            BenchResult res = measure(opt, "schema.encode", records, [&]() {
+                buffer.clear();
+            }, [&]() {
+                for(size_t i = 0; i < recs.size(); i++) {
+                    encodeRecord(recs[i], buffer);
+                }
+                return records;
+            });
+            res.bytes = (long long)buffer.size();
+            out.report(res);
+        }
+        
+        if(opt.selected("schema.decode")) {
+            out.report(measure(opt, "schema.decode", records, nullptr, [&]() {
+                Record rec;
+                long long decoded = 0;
+                const uint8_t* p = binary.data();
+                const uint8_t* end = p + binary.size();
+                while(p < end && decodeRecord(p, end, rec)) {
+                    sink = sink + rec.qty;
+                    decoded++;
+                }
+                return decoded;
+            }, (long long)binary.size()));
+        }
+        
+        if(opt.selected("schema.report")) {
+            std::string buffer;
+            char report[max_report_length];
+            BenchResult res = measure(opt, "schema.report", records, [&]() {
+                buffer.clear();
+            }, [&]() {
+                for(size_t i = 0; i < recs.size(); i++) {
+                    buffer.append(report, reportRecord(recs[i], report));
+                }
+                return records;
+            });
+            res.bytes = (long long)buffer.size();
+            out.report(res);
+        }
+    }
+    
+}
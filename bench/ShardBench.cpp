@@ -0,0 +1,74 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for ShardedInventory at increasing shard counts: batched quantity adjustments, single lookups through futures, and valuation combined across shards.
+ ----------------------------------------------- */
+
+#include <string.h>
+#include <future>
+#include <string>
+#include <thread>
+#include "ShardedInventory.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the sharded inventory benchmarks for one dataset
+    void shardBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        std::vector<iProduct*> products;
+        createProducts(recs, products);
+        
+        int count = (int)products.size();
+        long long size = (long long)recs.size();
+        int maxShards = opt.threads > 0 ? opt.threads : (int)std::thread::hardware_concurrency();
+        volatile double sink = 0.0;
+        
+        std::vector<Adjustment> changes(recs.size());
+        for(size_t i = 0; i < recs.size(); i++) {
+            memcpy(changes[i].sku, recs[i].sku, sizeof(changes[i].sku));
+            changes[i].delta = (i & 1) ? 1 : -1;
+        }
+        
+        for(int shards = 1; shards <= maxShards; shards *= 2) {
+            
+            ShardedInventory inventory(shards);
+            inventory.build(products.data(), count);
+            std::string suffix = "." + std::to_string(shards);
+            
+            if(opt.selected("shard.adjust.batch" + suffix)) {
+                out.report(measure(opt, "shard.adjust.batch" + suffix, size, nullptr, [&]() {
+                    return (long long)inventory.adjust(changes);
+                }));
+            }
+            
+            // keeps a window of requests in flight so every shard has work queued
+            if(opt.selected("shard.lookup" + suffix)) {
+                const size_t window = 256;
+                out.report(measure(opt, "shard.lookup" + suffix, size, nullptr, [&]() {
+                    std::vector<std::future<Record>> pending;
+                    long long found = 0;
+                    for(size_t i = 0; i < recs.size(); i += window) {
+                        size_t end = i + window < recs.size() ? i + window : recs.size();
+                        pending.clear();
+                        for(size_t j = i; j < end; j++) {
+                            pending.push_back(inventory.lookup(recs[j].sku));
+                        }
+                        for(size_t j = 0; j < pending.size(); j++) {
+                            found += pending[j].get().sku[0] != '\0';
+                        }
+                    }
+                    return found;
+                }));
+            }
+            
+            if(opt.selected("shard.valuation" + suffix)) {
+                out.report(measure(opt, "shard.valuation" + suffix, size, nullptr, [&]() {
+                    sink = inventory.valuation();
+                    return size;
+                }));
+            }
+        }
+        
+        destroyProducts(products);
+    }
+    
+}
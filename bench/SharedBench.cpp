@@ -0,0 +1,93 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks comparing SharedInventory with a reader-writer lock around in-place updates, for a mix of 99 reads to 1 update at 1 to 64 threads.
+ ----------------------------------------------- */
+
+#include <atomic>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include "SharedInventory.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    namespace {
+        
+        // runs ops operations split across threads, op(thread, n) performs operation n
+        void runThreads(int threads, long long ops, const std::function<void(int, long long)>& op) {
+            std::vector<std::thread> pool;
+            for(int t = 0; t < threads; t++) {
+                pool.push_back(std::thread([&, t]() {
+                    for(long long n = t; n < ops; n += threads) {
+                        op(t, n);
+                    }
+                }));
+            }
+            for(size_t t = 0; t < pool.size(); t++) {
+                pool[t].join();
+            }
+        }
+        
+        // spreads consecutive operations over the inventory
+        int position(long long n, int size) {
+            return (int)((unsigned long long)(n * 2654435761LL) % (unsigned long long)size);
+        }
+        
+    }
+    
+    // runs the shared inventory benchmarks for one dataset
+    void sharedBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        std::vector<iProduct*> products;
+        createProducts(recs, products);
+        
+        int count = (int)products.size();
+        long long size = (long long)recs.size();
+        int maxThreads = opt.threads > 0 ? opt.threads : 64;
+        std::vector<double> sinks(maxThreads);
+        
+        SharedInventory shared;
+        shared.build(products.data(), count);
+        
+        for(int threads = 1; threads <= maxThreads && threads <= 64; threads *= 2) {
+            
+            std::string name = "shared.epoch." + std::to_string(threads);
+            if(opt.selected(name)) {
+                out.report(measure(opt, name, size, nullptr, [&]() {
+                    runThreads(threads, size, [&](int t, long long n) {
+                        int i = position(n, count);
+                        if(n % 100 == 0) {
+                            shared.update(i, [](iProduct& prd) { prd.quantity(prd.quantity() + 1); });
+                        } else {
+                            EpochGuard guard(shared.domain());
+                            sinks[t] += shared.get(guard, i)->total_cost();
+                        }
+                    });
+                    return size;
+                }));
+            }
+            
+            // in-place updates need every reader locked out, as a plain Product vector would
+            name = "shared.rwlock." + std::to_string(threads);
+            if(opt.selected(name)) {
+                std::shared_timed_mutex lock;
+                out.report(measure(opt, name, size, nullptr, [&]() {
+                    runThreads(threads, size, [&](int t, long long n) {
+                        int i = position(n, count);
+                        if(n % 100 == 0) {
+                            std::unique_lock<std::shared_timed_mutex> write(lock);
+                            products[i]->quantity(products[i]->quantity() + 1);
+                        } else {
+                            std::shared_lock<std::shared_timed_mutex> read(lock);
+                            sinks[t] += products[i]->total_cost();
+                        }
+                    });
+                    return size;
+                }));
+            }
+        }
+        
+        destroyProducts(products);
+    }
+    
+}
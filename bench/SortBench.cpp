@@ -0,0 +1,62 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks for the ExternalSorter by each sort key, with a budget that holds the whole file and with a budget small enough to spill runs and merge them.
+ ----------------------------------------------- */
+
+#include <stdio.h>
+#include <string>
+#include "ExternalSort.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the external sort benchmarks for one dataset
+    void sortBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        const char* keys[3] = { "sku", "name", "expiry" };
+        const char* modes[2] = { "memory", "external" };
+        size_t budgets[2] = { 1ULL << 31, 4 << 20 };
+        
+        std::vector<std::string> names;
+        bool any = false;
+        for(int k = 0; k < 3; k++) {
+            for(int m = 0; m < 2; m++) {
+                names.push_back(std::string("sort.") + keys[k] + "." + modes[m]);
+                any = any || opt.selected(names.back());
+            }
+        }
+        if(!any) {
+            return;
+        }
+        
+        std::string input = opt.tempPath("sort-input.txt");
+        std::string output = opt.tempPath("sort-output.txt");
+        writeRecords(input.c_str(), recs);
+        
+        long long size = (long long)recs.size();
+        long long bytes = 0;
+        FILE* file = fopen(input.c_str(), "rb");
+        if(file != nullptr) {
+            fseek(file, 0, SEEK_END);
+            bytes = ftell(file);
+            fclose(file);
+        }
+        
+        for(int k = 0; k < 3; k++) {
+            for(int m = 0; m < 2; m++) {
+                const std::string& name = names[k * 2 + m];
+                if(!opt.selected(name)) {
+                    continue;
+                }
+                ExternalSorter sorter(budgets[m], opt.threads);
+                out.report(measure(opt, name, size, nullptr, [&]() {
+                    sorter.sort(input.c_str(), output.c_str(), (SortKey)k);
+                    return sorter.stats().records;
+                }, bytes));
+            }
+        }
+        
+        remove(input.c_str());
+        remove(output.c_str());
+    }
+    
+}
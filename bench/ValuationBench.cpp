@@ -0,0 +1,45 @@
+/* --------------------------------------------
+ Description: This implementation file contains the benchmarks comparing the serial operator+= valuation loop with the deterministic parallel valuation at increasing thread counts.
+ ----------------------------------------------- */
+
+#include <thread>
+#include "Valuation.h"
+#include "Bench.h"
+
+namespace AMA {
+    
+    // runs the valuation benchmarks for one dataset
+    void valuationBenchmarks(const BenchOptions& opt, const std::vector<Record>& recs, BenchReporter& out) {
+        
+        std::vector<iProduct*> products;
+        createProducts(recs, products);
+        
+        const iProduct* const* data = products.data();
+        int count = (int)products.size();
+        long long size = (long long)recs.size();
+        volatile double sink = 0.0;
+        
+        if(opt.selected("valuation.serial")) {
+            out.report(measure(opt, "valuation.serial", size, nullptr, [&]() {
+                sink = valuation(data, count);
+                return size;
+            }));
+        }
+        
+        int maxThreads = opt.threads > 0 ? opt.threads : (int)std::thread::hardware_concurrency();
+        
+        for(int threads = 1; threads <= (maxThreads > 0 ? maxThreads : 1); threads *= 2) {
+            std::string name = "valuation.parallel." + std::to_string(threads);
+            if(opt.selected(name)) {
+                out.report(measure(opt, name, size, nullptr, [&]() {
+                    sink = parallelValuation(data, count, threads);
+                    return size;
+                }));
+            }
+        }
+        
+        (void)sink;
+        destroyProducts(products);
+    }
+    
+}
@@ -0,0 +1,127 @@
+/* --------------------------------------------
+ Description: This is the benchmark driver. It generates a synthetic inventory for each requested size and runs every benchmark group on it, printing one result per line as JSON or CSV so runs from different versions can be compared with diff.
+ ----------------------------------------------- */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "Bench.h"
+
+using namespace AMA;
+
+// prints the command line options
+static void usage() {
+    std::cout << "usage: ama_bench [options]\n"
+    << "  --sizes N,N,...     dataset sizes in records (default 1000,100000)\n"
+    << "  --perishable F      fraction of perishable records (default 0.3)\n"
+    << "  --name-length N     longest product name (default 9)\n"
+    << "  --unit-length N     longest unit (default 6)\n"
+    << "  --units N           number of distinct units (default 40)\n"
+    << "  --expiry-days N     spread of expiry dates in days (default 1095)\n"
+    << "  --seed N            generator seed\n"
+    << "  --min-time S        seconds per measurement (default 0.2)\n"
+    << "  --threads N         largest thread count (default: hardware threads)\n"
+    << "  --filter TEXT       only run benchmarks whose name contains TEXT\n"
+    << "  --dir PATH          directory for temporary files (default /tmp)\n"
+    << "  --csv               print CSV instead of JSON lines\n"
+    << "  --out PATH          write results to PATH instead of standard output\n";
+}
+
+int main(int argc, char* argv[]) {
+    
+    BenchOptions opt;
+    bool csv = false;
+    std::string outPath;
+    
+    for(int i = 1; i < argc; i++) {
+        
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        
+        if(arg == "--csv") {
+            csv = true;
+            continue;
+        }
+        if(arg == "--help" || value == nullptr) {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+        
+        i++;
+        
+        if(arg == "--sizes") {
+            std::stringstream list(value);
+            std::string item;
+            opt.sizes.clear();
+            while(std::getline(list, item, ',')) {
+                opt.sizes.push_back(atoll(item.c_str()));
+            }
+        } else if(arg == "--perishable") {
+            opt.generator.perishable = atof(value);
+        } else if(arg == "--name-length") {
+            opt.generator.nameLength = atoi(value);
+        } else if(arg == "--unit-length") {
+            opt.generator.unitLength = atoi(value);
+        } else if(arg == "--units") {
+            opt.generator.units = atoi(value);
+        } else if(arg == "--expiry-days") {
+            opt.generator.expirySpread = atoi(value);
+        } else if(arg == "--seed") {
+            opt.generator.seed = (unsigned)atol(value);
+        } else if(arg == "--min-time") {
+            opt.minTime = atof(value);
+        } else if(arg == "--threads") {
+            opt.threads = atoi(value);
+        } else if(arg == "--filter") {
+            opt.filter = value;
+        } else if(arg == "--dir") {
+            opt.dir = value;
+        } else if(arg == "--out") {
+            outPath = value;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    
+    std::ofstream file;
+    
+    if(!outPath.empty()) {
+        file.open(outPath.c_str());
+        if(!file) {
+            std::cerr << "Unable to open " << outPath << std::endl;
+            return 1;
+        }
+    }
+    
+    BenchReporter out(outPath.empty() ? std::cout : file, csv);
+    
+    for(size_t s = 0; s < opt.sizes.size(); s++) {
+        std::vector<Record> recs;
+        generate(opt.generator, opt.sizes[s], recs);
+        fileBenchmarks(opt, recs, out);
+        valuationBenchmarks(opt, recs, out);
+        indexBenchmarks(opt, recs, out);
+        asyncBenchmarks(opt, recs, out);
+        poolBenchmarks(opt, recs, out);
+        compactBenchmarks(opt, recs, out);
+        changeBenchmarks(opt, recs, out);
+        sharedBenchmarks(opt, recs, out);
+        shardBenchmarks(opt, recs, out);
+        reconcileBenchmarks(opt, recs, out);
+        sortBenchmarks(opt, recs, out);
+        consolidateBenchmarks(opt, recs, out);
+        scanBenchmarks(opt, recs, out);
+        schemaBenchmarks(opt, recs, out);
+        latencyBenchmarks(opt, recs, out);
+        memoryBenchmarks(opt, recs, out);
+        reloadBenchmarks(opt, recs, out);
+        historyBenchmarks(opt, recs, out);
+        exportBenchmarks(opt, recs, out);
+    }
+    
+    return 0;
+}
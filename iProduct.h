@@ -13,6 +13,9 @@ namespace AMA {
         
     public:
         
+        // allows derived products to be destroyed through an iProduct pointer
+        virtual ~iProduct() { }
+        
         // stores the record to file
         virtual std::fstream& store(std::fstream& file, bool newLine=true) const = 0;
         